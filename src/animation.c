@@ -0,0 +1,64 @@
+/**********************************************************************************************
+*
+*   Animation Functions Definitions
+*
+*   Time-based playback of sprite sheet clips. Frame rects are computed once per clip
+*   when the sheet is loaded, playback advances on simulation time in the update and
+*   drawing is a plain table lookup. Sheets stay at their art size and are drawn
+*   SCALAR times larger.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------
+// Animation Functions Definition
+//----------------------------------------------------------------------------------
+void InitAnimationClip(AnimationClip *clip)
+{
+    if (clip->frameCount > ANIMATION_MAX_FRAMES) clip->frameCount = ANIMATION_MAX_FRAMES;
+    if (clip->frameCount < 1) clip->frameCount = 1;
+
+    float width = (float)(clip->sheet->width / clip->frameCount);
+    float height = (float)clip->sheet->height;
+
+    // Negative source width flips the frame for the left facing
+    for (int i = 0; i < clip->frameCount; i++) {
+        clip->frames[0][i] = (Rectangle){ width * i, 0.0f, width, height };
+        clip->frames[1][i] = (Rectangle){ width * i, 0.0f, -width, height };
+    }
+}
+
+void PlayAnimation(Animator *animator, const AnimationClip *clip)
+{
+    if (animator->clip == clip) return;
+
+    animator->clip = clip;
+    animator->frame = 0;
+    animator->elapsed = 0.0f;
+}
+
+void UpdateAnimation(Animator *animator, float dt)
+{
+    const AnimationClip *clip = animator->clip;
+    if ((clip == NULL) || (clip->frameTime <= 0.0f)) return;
+
+    animator->elapsed += dt;
+    while (animator->elapsed >= clip->frameTime) {
+        animator->elapsed -= clip->frameTime;
+        if (animator->frame < clip->frameCount - 1) animator->frame++;
+        else if (clip->loop == ANIMATION_LOOP) animator->frame = 0;
+        else animator->elapsed = 0.0f;
+    }
+}
+
+void DrawAnimation(const Animator *animator, Vector2 position, PlayerDirection direction, Color tint)
+{
+    const AnimationClip *clip = animator->clip;
+    Rectangle source = clip->frames[direction == LEFT][animator->frame];
+    Rectangle dest = { position.x, position.y, clip->frames[0][animator->frame].width * SCALAR, source.height * SCALAR };
+
+    DrawTexturePro(*clip->sheet, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, tint);
+}
@@ -0,0 +1,311 @@
+/**********************************************************************************************
+*
+*   Audio Thread Functions Definitions
+*
+*   The command queue is a fixed ring with one producer (the game thread) and one
+*   consumer (the worker): each side only writes its own index, published with
+*   release/acquire atomics. The worker wakes a few times per buffer length, runs the
+*   queued commands, steps fades and refills every playing stream.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "audio.h"
+#include <stdbool.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <time.h>
+#endif
+
+#define AUDIO_QUEUE_SIZE 64                 // Power of two
+#define AUDIO_MAX_TRACKS 4
+#define AUDIO_NOMINAL_RATE 44100
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum _AudioCommandType {
+    AUDIO_PLAY,
+    AUDIO_STOP,
+    AUDIO_VOLUME,
+    AUDIO_CROSSFADE
+} AudioCommandType;
+
+typedef struct _AudioCommand {
+    AudioCommandType type;
+    Music music;
+    float volume;
+    float seconds;
+} AudioCommand;
+
+typedef struct _MusicTrack {
+    bool active;
+    Music music;
+    float volume;
+    float target;
+    float rate;                 // Volume change per second while fading
+    bool stopAtTarget;          // Fading out
+} MusicTrack;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static AudioCommand commands[AUDIO_QUEUE_SIZE] = { 0 };
+static unsigned int commandHead = 0;        // Written by the game thread only
+static unsigned int commandTail = 0;        // Written by the worker only
+
+// Owned by the worker
+static MusicTrack tracks[AUDIO_MAX_TRACKS] = { 0 };
+
+static int bufferFrames = AUDIO_DEFAULT_BUFFER_FRAMES;
+
+#if !defined(PLATFORM_WEB)
+static pthread_t worker;
+static bool workerRunning = false;
+static bool workerQuit = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static MusicTrack *FindTrack(Music music)
+{
+    for (int i = 0; i < AUDIO_MAX_TRACKS; i++) {
+        if (tracks[i].active && (tracks[i].music.stream.buffer == music.stream.buffer)) return &tracks[i];
+    }
+    return NULL;
+}
+
+static MusicTrack *StartTrack(Music music, float volume)
+{
+    MusicTrack *track = FindTrack(music);
+
+    for (int i = 0; (track == NULL) && (i < AUDIO_MAX_TRACKS); i++) {
+        if (!tracks[i].active) track = &tracks[i];
+    }
+    if (track == NULL) {
+        TraceLog(LOG_WARNING, "AUDIO: All %i music tracks busy, play ignored", AUDIO_MAX_TRACKS);
+        return NULL;
+    }
+
+    if (!track->active) {
+        *track = (MusicTrack){ true, music, volume, volume, 0.0f, false };
+        SetMusicVolume(music, volume);
+        PlayMusicStream(music);
+    }
+    return track;
+}
+
+static void StopTrack(MusicTrack *track)
+{
+    StopMusicStream(track->music);
+    track->active = false;
+}
+
+static void FadeTrack(MusicTrack *track, float volume, float seconds, bool stop)
+{
+    track->target = volume;
+    track->stopAtTarget = stop;
+    track->rate = (seconds > 0.0f) ? ((track->volume > volume) ? track->volume - volume : volume - track->volume) / seconds : 0.0f;
+    if (seconds <= 0.0f) track->volume = volume;
+    SetMusicVolume(track->music, track->volume);
+}
+
+static void RunCommand(const AudioCommand *command)
+{
+    MusicTrack *track = FindTrack(command->music);
+
+    switch (command->type) {
+        case AUDIO_PLAY:
+        {
+            track = StartTrack(command->music, command->volume);
+            if (track != NULL) FadeTrack(track, command->volume, 0.0f, false);
+        } break;
+        case AUDIO_STOP:
+        {
+            if (track != NULL) StopTrack(track);
+        } break;
+        case AUDIO_VOLUME:
+        {
+            if (track != NULL) FadeTrack(track, command->volume, 0.0f, false);
+        } break;
+        case AUDIO_CROSSFADE:
+        {
+            for (int i = 0; i < AUDIO_MAX_TRACKS; i++) {
+                if (tracks[i].active && (&tracks[i] != track)) FadeTrack(&tracks[i], 0.0f, command->seconds, true);
+            }
+            if (track == NULL) track = StartTrack(command->music, 0.0f);
+            if (track != NULL) FadeTrack(track, command->volume, command->seconds, false);
+        } break;
+        default: break;
+    }
+}
+
+static void UpdateTracks(float dt)
+{
+    for (int i = 0; i < AUDIO_MAX_TRACKS; i++) {
+        MusicTrack *track = &tracks[i];
+        if (!track->active) continue;
+
+        if (track->volume != track->target) {
+            float step = track->rate * dt;
+            if (track->volume < track->target) track->volume = (track->volume + step < track->target) ? track->volume + step : track->target;
+            else track->volume = (track->volume - step > track->target) ? track->volume - step : track->target;
+            SetMusicVolume(track->music, track->volume);
+        }
+
+        if (track->stopAtTarget && (track->volume == track->target)) {
+            StopTrack(track);
+            continue;
+        }
+
+        if (!IsMusicStreamPlaying(track->music)) PlayMusicStream(track->music);
+        UpdateMusicStream(track->music);
+    }
+}
+
+static void RunQueuedCommands(void)
+{
+    unsigned int head = __atomic_load_n(&commandHead, __ATOMIC_ACQUIRE);
+    unsigned int tail = commandTail;
+
+    while (tail != head) {
+        RunCommand(&commands[tail & (AUDIO_QUEUE_SIZE - 1)]);
+        tail++;
+    }
+    __atomic_store_n(&commandTail, tail, __ATOMIC_RELEASE);
+}
+
+#if !defined(PLATFORM_WEB)
+static double GetMonotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void SleepSeconds(double seconds)
+{
+    struct timespec wait = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+    nanosleep(&wait, NULL);
+}
+
+static void *RunAudioWorker(void *data)
+{
+    // Wake four times per buffer so a refill is never more than a quarter buffer late
+    double period = (double)bufferFrames / AUDIO_NOMINAL_RATE / 4.0;
+    double last = GetMonotonicTime();
+
+    if (period < 0.001) period = 0.001;
+    if (period > 0.020) period = 0.020;
+
+    while (!__atomic_load_n(&workerQuit, __ATOMIC_ACQUIRE)) {
+        double now = GetMonotonicTime();
+
+        RunQueuedCommands();
+        UpdateTracks((float)(now - last));
+        last = now;
+
+        SleepSeconds(period);
+    }
+
+    RunQueuedCommands();
+    for (int i = 0; i < AUDIO_MAX_TRACKS; i++) {
+        if (tracks[i].active) StopTrack(&tracks[i]);
+    }
+
+    return NULL;
+}
+#endif
+
+static void PushCommand(AudioCommand command)
+{
+#if defined(PLATFORM_WEB)
+    RunCommand(&command);
+#else
+    if (!workerRunning) {
+        RunCommand(&command);
+        return;
+    }
+
+    unsigned int head = commandHead;
+
+    // Commands are rare, a full queue only means the worker is briefly behind
+    while (head - __atomic_load_n(&commandTail, __ATOMIC_ACQUIRE) >= AUDIO_QUEUE_SIZE) SleepSeconds(0.001);
+
+    commands[head & (AUDIO_QUEUE_SIZE - 1)] = command;
+    __atomic_store_n(&commandHead, head + 1, __ATOMIC_RELEASE);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Audio Thread Functions Definition
+//----------------------------------------------------------------------------------
+void InitAudioThread(int frames)
+{
+    bufferFrames = (frames > 0) ? frames : AUDIO_DEFAULT_BUFFER_FRAMES;
+    SetAudioStreamBufferSizeDefault(bufferFrames);
+
+#if !defined(PLATFORM_WEB)
+    workerQuit = false;
+    workerRunning = (pthread_create(&worker, NULL, RunAudioWorker, NULL) == 0);
+    if (!workerRunning) TraceLog(LOG_WARNING, "AUDIO: Worker thread failed, streaming from the main loop");
+#endif
+}
+
+void CloseAudioThread(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (workerRunning) {
+        __atomic_store_n(&workerQuit, true, __ATOMIC_RELEASE);
+        pthread_join(worker, NULL);
+        workerRunning = false;
+        return;
+    }
+#endif
+    for (int i = 0; i < AUDIO_MAX_TRACKS; i++) {
+        if (tracks[i].active) StopTrack(&tracks[i]);
+    }
+}
+
+int GetAudioBufferFrames(void)
+{
+    return bufferFrames;
+}
+
+void UpdateAudioThread(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (workerRunning) return;
+#endif
+    UpdateTracks(GetFrameTime());
+}
+
+void FlushAudioCommands(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (!workerRunning) return;
+    while (__atomic_load_n(&commandTail, __ATOMIC_ACQUIRE) != commandHead) SleepSeconds(0.001);
+#endif
+}
+
+void PlayMusicAsync(Music music, float volume)
+{
+    PushCommand((AudioCommand){ AUDIO_PLAY, music, volume, 0.0f });
+}
+
+void StopMusicAsync(Music music)
+{
+    PushCommand((AudioCommand){ AUDIO_STOP, music, 0.0f, 0.0f });
+}
+
+void SetMusicVolumeAsync(Music music, float volume)
+{
+    PushCommand((AudioCommand){ AUDIO_VOLUME, music, volume, 0.0f });
+}
+
+void CrossfadeMusicAsync(Music music, float volume, float seconds)
+{
+    PushCommand((AudioCommand){ AUDIO_CROSSFADE, music, volume, seconds });
+}
@@ -0,0 +1,46 @@
+/**********************************************************************************************
+*
+*   Audio Thread
+*
+*   Music decoding and stream refills run on a worker thread instead of the screen
+*   updates, so a long frame (screen init, asset loads) does not underrun the stream.
+*   Game code only pushes commands (play, stop, volume, crossfade) into a single
+*   producer lock-free queue; the worker owns every Music it was told to play until
+*   it is stopped.
+*
+*   Unloading a Music: StopMusicAsync() then FlushAudioCommands() before unloading, so
+*   the worker no longer touches it. Sounds are unaffected and still played directly.
+*
+*   On PLATFORM_WEB there are no threads, commands run immediately and
+*   UpdateAudioThread() refills the streams once per frame.
+*
+**********************************************************************************************/
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#define AUDIO_DEFAULT_BUFFER_FRAMES 4096    // Per stream sub-buffer, ~93 ms at 44.1 kHz
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Audio Thread Functions Declaration
+//----------------------------------------------------------------------------------
+void InitAudioThread(int bufferFrames);             // After InitAudioDevice(), before loading music
+void CloseAudioThread(void);                        // Stops all music, before CloseAudioDevice()
+int GetAudioBufferFrames(void);
+void UpdateAudioThread(void);                       // Once per frame, only does work without threads
+void FlushAudioCommands(void);                      // Wait until the worker ran every queued command
+
+void PlayMusicAsync(Music music, float volume);     // Restarts when it ends
+void StopMusicAsync(Music music);
+void SetMusicVolumeAsync(Music music, float volume);
+void CrossfadeMusicAsync(Music music, float volume, float seconds);  // Fades in music, fades out and stops all others
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_H
@@ -0,0 +1,426 @@
+/**********************************************************************************************
+*
+*   Render Benchmark Functions Definitions
+*
+*   A frame is timed in three parts: update (audio thread, gameplay update and the one
+*   simulation tick), draw (the gameplay screen into the display target and the blit to
+*   the window) and present (EndDrawing(): the last batch flush and the swap, where a
+*   software driver does most of its rasterizing). Warmup frames run the same way but
+*   are not kept, the script starts with them.
+*
+*   rlgl reaches GL through glad's function pointers and draws with glDrawArrays() and
+*   glDrawElements() only; the benchmark swaps those two pointers for counting wrappers,
+*   so a draw call is a real one the driver received, batch flushes included.
+*
+*   A stress room is walls around an open square of the chosen size: the start in its
+*   top left corner, every other open tile a hazard at the chosen density, some ground
+*   in between. It has no exit, so the benchmark never leaves it.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "bench.h"
+#include "screens.h"
+#include "gameplay.h"
+#include "display.h"
+#include "pacing.h"
+#include "quality.h"
+#include "audio.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PLATFORM_DESKTOP) && defined(__linux__)
+    #define BENCH_DRAW_CALLS
+    #include <GL/gl.h>
+#endif
+
+#define BENCH_DEFAULT_OUTPUT "benchmark.json"
+#define BENCH_DEFAULT_SCRIPT "R60 W20 T W40 L60 W20 T W40 R30 T W30 L30 W10 T W30"
+#define BENCH_STRESS_GROUND 0.15f           // Share of the open tiles that are ground, besides the hazards
+#define BENCH_STRESS_SEED 0x2545f491u
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _ScriptStep {
+    int input;
+    int ticks;
+} ScriptStep;
+
+typedef struct _BenchmarkFrame {
+    float update;
+    float draw;
+    float present;
+    float total;
+    int drawCalls;
+} BenchmarkFrame;
+
+#if defined(BENCH_DRAW_CALLS)
+typedef void (APIENTRY *DrawArraysFunc)(GLenum mode, GLint first, GLsizei count);
+typedef void (APIENTRY *DrawElementsFunc)(GLenum mode, GLsizei count, GLenum type, const void *indices);
+
+// Defined by raylib's copy of glad, filled when the window opens
+extern DrawArraysFunc glad_glDrawArrays;
+extern DrawElementsFunc glad_glDrawElements;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool requested = false;
+static int room = 0;
+static float stressDensity = -1.0f;         // No stress room while negative
+static int stressSize = ROOM_SIZE - 2;
+static int frameCount = BENCH_DEFAULT_FRAMES;
+static int warmupCount = BENCH_DEFAULT_WARMUP;
+static const char *scriptFile = NULL;
+static int quality = QUALITY_LEVELS - 1;
+static const char *outputFile = BENCH_DEFAULT_OUTPUT;
+
+static ScriptStep script[BENCH_MAX_SCRIPT_STEPS] = { 0 };
+static int scriptLength = 0;
+static int scriptStep = 0;
+static int stepTicks = 0;                   // Ticks spent in the current step
+
+static BenchmarkFrame *samples = NULL;
+static int measured = 0;
+static int frame = 0;                       // Warmup included
+static double startTime = 0.0;              // First measured frame
+static char renderer[128] = "unknown";
+static int drawCalls = 0;
+
+#if defined(BENCH_DRAW_CALLS)
+static DrawArraysFunc drawArrays = NULL;
+static DrawElementsFunc drawElements = NULL;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(BENCH_DRAW_CALLS)
+static void APIENTRY CountDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    drawCalls++;
+    drawArrays(mode, first, count);
+}
+
+static void APIENTRY CountDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    drawCalls++;
+    drawElements(mode, count, type, indices);
+}
+#endif
+
+static unsigned int NextRandom(unsigned int *seed)
+{
+    unsigned int x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+static void PrintUsage(void)
+{
+    fprintf(stderr, "Usage: raylib_game --bench [--bench-room n] [--bench-stress density] [--bench-size tiles]\n"
+                    "       [--bench-frames n] [--bench-warmup n] [--bench-script file] [--bench-quality level]\n"
+                    "       [--bench-output file]\n");
+}
+
+// Same format as the playtest harness: whitespace separated steps, a letter with an optional
+// tick count. L = left, R = right, T = rotate, W = wait. Example: "R90 T W30 L45"
+static bool ParseScript(const char *text)
+{
+    char token[32];
+    int length = 0;
+
+    scriptLength = 0;
+    while ((scriptLength < BENCH_MAX_SCRIPT_STEPS) && (sscanf(text, "%31s%n", token, &length) == 1)) {
+        ScriptStep step = { INPUT_NONE, 1 };
+
+        text += length;
+        switch (token[0]) {
+            case 'L': step.input = INPUT_LEFT; break;
+            case 'R': step.input = INPUT_RIGHT; break;
+            case 'T': step.input = INPUT_ROTATE; break;
+            case 'W': break;
+            default: return false;
+        }
+        if (token[1] != '\0') step.ticks = atoi(token + 1);
+        if (step.ticks < 1) step.ticks = 1;
+        script[scriptLength++] = step;
+    }
+    return (scriptLength > 0);
+}
+
+// The script loops for as long as the benchmark runs
+static int NextScriptInput(void)
+{
+    int input = script[scriptStep].input;
+
+    if (++stepTicks >= script[scriptStep].ticks) {
+        stepTicks = 0;
+        scriptStep = (scriptStep + 1) % scriptLength;
+    }
+    return input;
+}
+
+static void SetStressRoom(void)
+{
+    TileType tiles[ROOM_SIZE][ROOM_SIZE] = { 0 };
+    int first = (ROOM_SIZE - stressSize) / 2;
+    unsigned int seed = BENCH_STRESS_SEED;
+
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) {
+            bool open = (i >= first) && (i < first + stressSize) && (j >= first) && (j < first + stressSize);
+            float roll = (float)(NextRandom(&seed) % 10000) / 10000.0f;
+
+            if (!open) tiles[i][j] = GROUND;
+            else if (roll < stressDensity) tiles[i][j] = (NextRandom(&seed) & 1) ? STALAGMITE : STALACTITE;
+            else if (roll < stressDensity + BENCH_STRESS_GROUND) tiles[i][j] = GROUND;
+            else tiles[i][j] = AIR;
+        }
+    }
+    tiles[first][first] = START;
+
+    SetRoomTiles(room, tiles);
+}
+
+static int CompareFloats(const void *a, const void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank, values are sorted
+static float GetPercentile(const float *values, int count, int percent)
+{
+    int rank = (percent * count + 99) / 100;
+    return values[(rank > 0) ? rank - 1 : 0];
+}
+
+// Milliseconds, values are seconds and get sorted
+static void WriteTimeStats(FILE *file, const char *name, float *values, int count)
+{
+    double sum = 0.0;
+
+    qsort(values, count, sizeof(float), CompareFloats);
+    for (int i = 0; i < count; i++) sum += values[i];
+
+    fprintf(file, "  \"%s\": { \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n", name,
+            sum / count * 1000.0, GetPercentile(values, count, 50) * 1000.0f, GetPercentile(values, count, 95) * 1000.0f,
+            GetPercentile(values, count, 99) * 1000.0f, values[count - 1] * 1000.0f);
+}
+
+static void WriteJsonString(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (; *text != '\0'; text++) {
+        if ((*text == '"') || (*text == '\\')) fprintf(file, "\\%c", *text);
+        else if ((unsigned char)*text < 0x20) fputc(' ', file);
+        else fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+//----------------------------------------------------------------------------------
+// Benchmark Functions Definition
+//----------------------------------------------------------------------------------
+bool ParseBenchmarkOptions(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--bench") == 0) {
+            requested = true;
+            continue;
+        }
+
+        const char *value = (i + 1 < argc) ? argv[++i] : NULL;
+
+        if ((strncmp(arg, "--bench-", 8) != 0) || (value == NULL)) {
+            fprintf(stderr, "raylib_game: %s %s\n", (value == NULL) ? "missing value for" : "unknown option", arg);
+            PrintUsage();
+            return false;
+        }
+        requested = true;
+
+        if (strcmp(arg, "--bench-room") == 0) room = atoi(value);
+        else if (strcmp(arg, "--bench-stress") == 0) stressDensity = (float)atof(value);
+        else if (strcmp(arg, "--bench-size") == 0) stressSize = atoi(value);
+        else if (strcmp(arg, "--bench-frames") == 0) frameCount = atoi(value);
+        else if (strcmp(arg, "--bench-warmup") == 0) warmupCount = atoi(value);
+        else if (strcmp(arg, "--bench-script") == 0) scriptFile = value;
+        else if (strcmp(arg, "--bench-quality") == 0) quality = atoi(value);
+        else if (strcmp(arg, "--bench-output") == 0) outputFile = value;
+        else {
+            fprintf(stderr, "raylib_game: unknown option %s\n", arg);
+            PrintUsage();
+            return false;
+        }
+    }
+
+    if (!requested) return true;
+
+    bool valid = true;
+
+    if ((room < 0) || (room >= GetRoomCount())) valid = false;
+    if ((stressDensity > 1.0f) || (stressSize < 2) || (stressSize > ROOM_SIZE - 2)) valid = false;
+    if ((frameCount < 1) || (warmupCount < 0) || (quality < 0) || (quality >= QUALITY_LEVELS)) valid = false;
+    if (!valid) {
+        fprintf(stderr, "raylib_game: benchmark option out of range (room 0-%i, stress 0-1, size 2-%i, quality 0-%i)\n",
+                GetRoomCount() - 1, ROOM_SIZE - 2, QUALITY_LEVELS - 1);
+        return false;
+    }
+
+    if (scriptFile != NULL) {
+        char *text = LoadFileText(scriptFile);
+
+        valid = (text != NULL) && ParseScript(text);
+        UnloadFileText(text);
+    }
+    else valid = ParseScript(BENCH_DEFAULT_SCRIPT);
+
+    if (!valid) fprintf(stderr, "raylib_game: [%s] Invalid benchmark script\n", scriptFile);
+    return valid;
+}
+
+bool IsBenchmarkRequested(void)
+{
+    return requested;
+}
+
+void StartBenchmark(void)
+{
+    samples = (BenchmarkFrame *)MemAllocTracked(frameCount * sizeof(BenchmarkFrame), "benchmark frames");
+    measured = 0;
+    frame = 0;
+    scriptStep = 0;
+    stepTicks = 0;
+
+    // The gameplay screen leaves the rooms to the benchmark
+    LoadRoomFiles();
+    if (stressDensity >= 0.0f) SetStressRoom();
+    SetGameplayBenchmark(true);
+    SetGameplayRoom(room);
+    SetSimulationStepped(true);
+    SetScriptedGameInput(INPUT_NONE);
+
+    SetFramePacing(PACING_UNCAPPED, 0);
+    InitQualityGovernor();
+    SetQualityLevel(quality);
+
+    InitGameplayScreen();
+
+#if defined(BENCH_DRAW_CALLS)
+    const char *name = (const char *)glGetString(GL_RENDERER);
+    if (name != NULL) snprintf(renderer, sizeof(renderer), "%s", name);
+
+    drawArrays = glad_glDrawArrays;
+    drawElements = glad_glDrawElements;
+    glad_glDrawArrays = CountDrawArrays;
+    glad_glDrawElements = CountDrawElements;
+#endif
+    drawCalls = 0;
+
+    if (stressDensity >= 0.0f) TraceLog(LOG_INFO, "BENCH: %i frames in a %ix%i stress room, %.0f%% hazards", frameCount, stressSize, stressSize, stressDensity * 100.0f);
+    else TraceLog(LOG_INFO, "BENCH: %i frames in room %i", frameCount, room);
+}
+
+bool UpdateBenchmarkFrame(void)
+{
+    double start = GetTime();
+
+    if (frame == warmupCount) startTime = start;
+
+    SetScriptedGameInput(NextScriptInput());
+    UpdateAudioThread();
+    UpdateGameplayScreen();
+    double updated = GetTime();
+
+    BeginDisplay();
+        ClearBackground(RAYWHITE);
+        DrawGameplayScreen();
+    EndDisplay();
+    double drawn = GetTime();
+
+    EndDrawing();
+    double presented = GetTime();
+
+    if (frame >= warmupCount) {
+        samples[measured++] = (BenchmarkFrame){ (float)(updated - start), (float)(drawn - updated), (float)(presented - drawn),
+                                                (float)(presented - start), drawCalls };
+    }
+    drawCalls = 0;
+    frame++;
+
+    return (measured < frameCount);
+}
+
+bool FinishBenchmark(void)
+{
+#if defined(BENCH_DRAW_CALLS)
+    glad_glDrawArrays = drawArrays;
+    glad_glDrawElements = drawElements;
+#endif
+    SetScriptedGameInput(-1);
+    SetSimulationStepped(false);
+    SetGameplayBenchmark(false);
+
+    bool written = false;
+    FILE *file = NULL;
+
+    if (measured > 0) file = fopen(outputFile, "w");
+
+    if (measured == 0) TraceLog(LOG_WARNING, "BENCH: Stopped before the first measured frame, no report");
+    else if (file == NULL) TraceLog(LOG_WARNING, "BENCH: [%s] Could not write the report", outputFile);
+    else {
+        float *values = (float *)MemAllocTracked(measured * sizeof(float), "benchmark report");
+
+        fprintf(file, "{\n  \"frames\": %i,\n  \"warmup\": %i,\n  \"seconds\": %.3f,\n", measured, warmupCount, GetTime() - startTime);
+        fprintf(file, "  \"room\": %i,\n", room);
+        if (stressDensity >= 0.0f) fprintf(file, "  \"stress\": { \"size\": %i, \"hazards\": %.3f },\n", stressSize, stressDensity);
+        else fprintf(file, "  \"stress\": null,\n");
+        fprintf(file, "  \"script\": ");
+        WriteJsonString(file, (scriptFile != NULL) ? scriptFile : "default");
+        fprintf(file, ",\n  \"quality\": %i,\n  \"renderer\": ", quality);
+        WriteJsonString(file, renderer);
+        fprintf(file, ",\n");
+
+        for (int i = 0; i < measured; i++) values[i] = samples[i].total;
+        WriteTimeStats(file, "frame_ms", values, measured);
+        for (int i = 0; i < measured; i++) values[i] = samples[i].update;
+        WriteTimeStats(file, "update_ms", values, measured);
+        for (int i = 0; i < measured; i++) values[i] = samples[i].draw;
+        WriteTimeStats(file, "draw_ms", values, measured);
+        for (int i = 0; i < measured; i++) values[i] = samples[i].present;
+        WriteTimeStats(file, "present_ms", values, measured);
+
+#if defined(BENCH_DRAW_CALLS)
+        int maxDrawCalls = 0;
+        double drawCallSum = 0.0;
+
+        for (int i = 0; i < measured; i++) {
+            drawCallSum += samples[i].drawCalls;
+            if (samples[i].drawCalls > maxDrawCalls) maxDrawCalls = samples[i].drawCalls;
+        }
+        fprintf(file, "  \"draw_calls\": { \"mean\": %.2f, \"max\": %i }\n}\n", drawCallSum / measured, maxDrawCalls);
+#else
+        fprintf(file, "  \"draw_calls\": null\n}\n");
+#endif
+        MemFreeTracked(values);
+
+        written = (fclose(file) == 0);
+        if (written) TraceLog(LOG_INFO, "BENCH: [%s] Report written", outputFile);
+        else TraceLog(LOG_WARNING, "BENCH: [%s] Could not write the report", outputFile);
+    }
+
+    MemFreeTracked(samples);
+    samples = NULL;
+    return written;
+}
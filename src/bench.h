@@ -0,0 +1,55 @@
+/**********************************************************************************************
+*
+*   Render Benchmark
+*
+*   Runs the whole game loop, not a part of it, the same way on every machine so builds
+*   can be compared: the gameplay screen starts right away in a chosen room, or in a
+*   generated stress room, with vsync off and a fixed quality level. A scripted input
+*   sequence drives it for a fixed number of frames, the simulation takes exactly one
+*   tick per frame and the background seed is fixed. The JSON report has percentiles of
+*   the frame time and of its update, draw and present parts, plus draw calls per frame.
+*   Telemetry is not recorded and hot reload stays off while benchmarking.
+*
+*   Usage: ./raylib_game --bench [options]
+*       --bench-room <n>            Room to start in (default: 0)
+*       --bench-stress <density>    Generated room instead, share of the open tiles that
+*                                   are hazards, 0 to 1
+*       --bench-size <n>            Side of the generated room's open area in tiles
+*                                   (default: ROOM_SIZE - 2, the whole room inside its walls)
+*       --bench-frames <n>          Frames measured (default: 1800)
+*       --bench-warmup <n>          Frames run first, not measured (default: 120)
+*       --bench-script <file>       Input script, same format as the playtest harness
+*                                   (default: a loop walking and rotating both ways)
+*       --bench-quality <n>         Quality level, 0 lowest (default: QUALITY_LEVELS - 1)
+*       --bench-output <file>       Report file (default: benchmark.json)
+*
+*   No GPU needed, Mesa renders in software: xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1
+*   ./raylib_game --bench. Draw calls are counted on desktop Linux only (null elsewhere).
+*
+**********************************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#define BENCH_DEFAULT_FRAMES 1800
+#define BENCH_DEFAULT_WARMUP 120
+#define BENCH_MAX_SCRIPT_STEPS 1024
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Benchmark Functions Declaration
+//----------------------------------------------------------------------------------
+bool ParseBenchmarkOptions(int argc, char *argv[]);     // False on a bad option, usage is printed
+bool IsBenchmarkRequested(void);
+void StartBenchmark(void);                  // Instead of the logo screen, inits the gameplay screen
+bool UpdateBenchmarkFrame(void);            // Instead of the game frame, false once every frame ran
+bool FinishBenchmark(void);                 // Report over the frames measured so far, false if not written
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H
@@ -0,0 +1,451 @@
+/**********************************************************************************************
+*
+*   Capture Functions Definitions
+*
+*   Each frame: the buffers whose fence signaled are mapped oldest first and copied into
+*   the encoder queue, then the target is read into the next buffer of the ring and a
+*   fence is put behind the read. Only when the ring wraps onto a read that is still not
+*   done (a GPU several frames behind) does the main thread wait for it.
+*
+*   The queue is a single producer / single consumer ring of frame-sized buffers, each
+*   side only writes its own index. The encoder compresses to QOI, a lossless format
+*   simple and fast enough to keep up at 60 fps on one thread, and numbers the files
+*   without gaps: frames.csv maps every file to its game frame, so drops still show.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "capture.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PLATFORM_DESKTOP) && defined(__linux__)
+    #define CAPTURE_SUPPORTED
+    #define GL_GLEXT_PROTOTYPES
+    #include <GL/gl.h>
+    #include <GL/glext.h>
+    #include <pthread.h>
+    #include <errno.h>
+    #include <sys/stat.h>
+#endif
+
+#define CAPTURE_MAX_PATH 256
+#define CAPTURE_WAIT_TIMEOUT 100000000      // Nanoseconds, only when the ring wrapped onto an unfinished read
+#define CAPTURE_IDLE_SLEEP 2000000          // Nanoseconds the encoder sleeps with nothing queued
+
+#if defined(CAPTURE_SUPPORTED)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _CaptureBuffer {
+    GLuint buffer;
+    GLsync fence;
+    bool pending;                   // Read issued, not collected yet
+    unsigned int frame;
+    double time;
+} CaptureBuffer;
+
+typedef struct _QueuedFrame {
+    unsigned char *pixels;          // Bottom-up rows, as GL reads them
+    unsigned int frame;
+    double time;
+} QueuedFrame;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool capturing = false;
+static char captureDirectory[CAPTURE_MAX_PATH] = { 0 };
+static double captureStart = 0.0;
+static int frameWidth = 0;                  // 0 until the first frame sized the buffers
+static int frameHeight = 0;
+static unsigned int frameCount = 0;
+
+static CaptureBuffer buffers[CAPTURE_PBO_COUNT] = { 0 };
+static int nextBuffer = 0;
+
+static QueuedFrame queue[CAPTURE_QUEUE_FRAMES] = { 0 };
+static unsigned int queueHead = 0;          // Written by the main thread only
+static unsigned int queueTail = 0;          // Written by the encoder only
+
+// Owned by the encoder while it runs
+static unsigned char *encoded = NULL;
+static FILE *timesFile = NULL;
+static unsigned int framesWritten = 0;
+
+static unsigned int framesDropped = 0;
+static double mainTime = 0.0;
+static double mainMaxTime = 0.0;
+
+static pthread_t encoder;
+static bool encoderQuit = false;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static double GetMonotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int GetFrameBytes(void)
+{
+    return frameWidth * frameHeight * 4;
+}
+
+static int WriteBigEndian(unsigned char *out, unsigned int value)
+{
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+    return 4;
+}
+
+// QOI (qoiformat.org) without alpha, rows are taken bottom-up so the image is not flipped
+static int EncodeFrame(const unsigned char *pixels, unsigned char *out)
+{
+    unsigned char index[64][3] = { 0 };
+    bool indexed[64] = { 0 };
+    unsigned char prev[3] = { 0, 0, 0 };
+    int run = 0;
+    int size = 0;
+
+    memcpy(out, "qoif", 4);
+    size += 4;
+    size += WriteBigEndian(out + size, frameWidth);
+    size += WriteBigEndian(out + size, frameHeight);
+    out[size++] = 3;            // RGB
+    out[size++] = 0;            // sRGB
+
+    for (int y = frameHeight - 1; y >= 0; y--) {
+        const unsigned char *row = pixels + (size_t)y * frameWidth * 4;
+
+        for (int x = 0; x < frameWidth; x++) {
+            unsigned char r = row[x * 4 + 0];
+            unsigned char g = row[x * 4 + 1];
+            unsigned char b = row[x * 4 + 2];
+
+            if ((r == prev[0]) && (g == prev[1]) && (b == prev[2])) {
+                if (++run == 62) {
+                    out[size++] = 0xc0 | (run - 1);
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out[size++] = 0xc0 | (run - 1);
+                run = 0;
+            }
+
+            int hash = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+
+            if (indexed[hash] && (index[hash][0] == r) && (index[hash][1] == g) && (index[hash][2] == b)) out[size++] = (unsigned char)hash;
+            else {
+                signed char dr = (signed char)(r - prev[0]);
+                signed char dg = (signed char)(g - prev[1]);
+                signed char db = (signed char)(b - prev[2]);
+                signed char drg = (signed char)(dr - dg);
+                signed char dbg = (signed char)(db - dg);
+
+                index[hash][0] = r;
+                index[hash][1] = g;
+                index[hash][2] = b;
+                indexed[hash] = true;
+
+                if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1)) {
+                    out[size++] = 0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+                }
+                else if ((dg >= -32) && (dg <= 31) && (drg >= -8) && (drg <= 7) && (dbg >= -8) && (dbg <= 7)) {
+                    out[size++] = 0x80 | (dg + 32);
+                    out[size++] = ((drg + 8) << 4) | (dbg + 8);
+                }
+                else {
+                    out[size++] = 0xfe;
+                    out[size++] = r;
+                    out[size++] = g;
+                    out[size++] = b;
+                }
+            }
+
+            prev[0] = r;
+            prev[1] = g;
+            prev[2] = b;
+        }
+    }
+    if (run > 0) out[size++] = 0xc0 | (run - 1);
+
+    // End marker
+    memset(out + size, 0, 7);
+    size += 7;
+    out[size++] = 1;
+
+    return size;
+}
+
+static void WriteFrame(const QueuedFrame *frame)
+{
+    char path[CAPTURE_MAX_PATH + 32];
+    int size = EncodeFrame(frame->pixels, encoded);
+
+    snprintf(path, sizeof(path), "%s/frame_%06u.qoi", captureDirectory, framesWritten);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return;
+    fwrite(encoded, 1, size, file);
+    fclose(file);
+
+    if (timesFile != NULL) fprintf(timesFile, "%u,%u,%.3f\n", framesWritten, frame->frame, frame->time * 1000.0);
+    framesWritten++;
+}
+
+static void *RunEncoder(void *data)
+{
+    struct timespec idle = { 0, CAPTURE_IDLE_SLEEP };
+
+    for (;;) {
+        // Quit is read first: the main thread publishes its last frame before setting it
+        bool quit = __atomic_load_n(&encoderQuit, __ATOMIC_ACQUIRE);
+        unsigned int tail = queueTail;
+
+        if (tail == __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE)) {
+            if (quit) break;
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        WriteFrame(&queue[tail & (CAPTURE_QUEUE_FRAMES - 1)]);
+        __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+static bool IsBufferReady(const CaptureBuffer *buffer)
+{
+    GLenum status = glClientWaitSync(buffer->fence, 0, 0);
+    return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+}
+
+// Map a finished read and queue it; wait is for stopping, when nothing may be dropped
+static void CollectBuffer(CaptureBuffer *buffer, bool wait)
+{
+    struct timespec idle = { 0, CAPTURE_IDLE_SLEEP };
+    unsigned int head = queueHead;
+
+    glClientWaitSync(buffer->fence, GL_SYNC_FLUSH_COMMANDS_BIT, CAPTURE_WAIT_TIMEOUT);
+    glDeleteSync(buffer->fence);
+    buffer->pending = false;
+
+    if (wait) {
+        while (head - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE) >= CAPTURE_QUEUE_FRAMES) nanosleep(&idle, NULL);
+    }
+    else if (head - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE) >= CAPTURE_QUEUE_FRAMES) {
+        framesDropped++;        // Encoder behind
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer);
+    const void *pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GetFrameBytes(), GL_MAP_READ_BIT);
+
+    if (pixels != NULL) {
+        QueuedFrame *frame = &queue[head & (CAPTURE_QUEUE_FRAMES - 1)];
+
+        memcpy(frame->pixels, pixels, GetFrameBytes());
+        frame->frame = buffer->frame;
+        frame->time = buffer->time;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+    }
+    else framesDropped++;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// Buffers are sized on the first frame, the target is only known then
+static bool OpenCapture(int width, int height)
+{
+    frameWidth = width;
+    frameHeight = height;
+
+    GLuint ids[CAPTURE_PBO_COUNT] = { 0 };
+    glGenBuffers(CAPTURE_PBO_COUNT, ids);
+    for (int i = 0; i < CAPTURE_PBO_COUNT; i++) {
+        buffers[i] = (CaptureBuffer){ ids[i], NULL, false, 0, 0.0 };
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, ids[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, GetFrameBytes(), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    TrackMemory(MEMORY_TEXTURE, (uintptr_t)buffers, (size_t)CAPTURE_PBO_COUNT * GetFrameBytes(), "capture buffers");
+
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; i++) queue[i].pixels = MemAllocTracked(GetFrameBytes(), "capture frames");
+    encoded = MemAllocTracked(GetFrameBytes() + 32, "capture encoder");     // Worst case 4 bytes per pixel, plus header and end marker
+    nextBuffer = 0;
+    queueHead = 0;
+    queueTail = 0;
+    framesWritten = 0;
+
+    encoderQuit = false;
+    if (pthread_create(&encoder, NULL, RunEncoder, NULL) != 0) {
+        TraceLog(LOG_WARNING, "CAPTURE: Encoder thread failed, recording stopped");
+        return false;
+    }
+    return true;
+}
+
+static void CloseCapture(bool encoderRunning)
+{
+    if (encoderRunning) {
+        __atomic_store_n(&encoderQuit, true, __ATOMIC_RELEASE);
+        pthread_join(encoder, NULL);
+    }
+
+    for (int i = 0; i < CAPTURE_PBO_COUNT; i++) {
+        if (buffers[i].pending) glDeleteSync(buffers[i].fence);
+        glDeleteBuffers(1, &buffers[i].buffer);
+        buffers[i] = (CaptureBuffer){ 0 };
+    }
+    UntrackMemory(MEMORY_TEXTURE, (uintptr_t)buffers);
+
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; i++) MemFreeTracked(queue[i].pixels);
+    MemFreeTracked(encoded);
+    encoded = NULL;
+    frameWidth = 0;
+    frameHeight = 0;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Capture Functions Definition
+//----------------------------------------------------------------------------------
+bool StartCapture(const char *directory)
+{
+#if defined(CAPTURE_SUPPORTED)
+    if (capturing) return true;
+
+    if ((rlGetVersion() != RL_OPENGL_33) && (rlGetVersion() != RL_OPENGL_43)) {
+        TraceLog(LOG_WARNING, "CAPTURE: Needs OpenGL 3.3, not recording");
+        return false;
+    }
+
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+    snprintf(captureDirectory, sizeof(captureDirectory), "%s/%s", directory, stamp);
+
+    mkdir(directory, 0755);
+    if ((mkdir(captureDirectory, 0755) != 0) && (errno != EEXIST)) {
+        TraceLog(LOG_WARNING, "CAPTURE: [%s] Could not create the directory, not recording", captureDirectory);
+        return false;
+    }
+
+    timesFile = fopen(TextFormat("%s/frames.csv", captureDirectory), "w");
+    if (timesFile != NULL) fprintf(timesFile, "file,frame,time_ms\n");
+
+    capturing = true;
+    captureStart = GetMonotonicTime();
+    frameCount = 0;
+    framesDropped = 0;
+    mainTime = 0.0;
+    mainMaxTime = 0.0;
+    TraceLog(LOG_INFO, "CAPTURE: [%s] Recording started", captureDirectory);
+    return true;
+#else
+    TraceLog(LOG_WARNING, "CAPTURE: Not supported on this platform");
+    return false;
+#endif
+}
+
+void StopCapture(void)
+{
+#if defined(CAPTURE_SUPPORTED)
+    if (!capturing) return;
+
+    if (frameWidth > 0) {
+        // Oldest first, so the last frames are written in order
+        for (int i = 0; i < CAPTURE_PBO_COUNT; i++) {
+            CaptureBuffer *buffer = &buffers[(nextBuffer + i) % CAPTURE_PBO_COUNT];
+            if (buffer->pending) CollectBuffer(buffer, true);
+        }
+        CloseCapture(true);
+    }
+
+    if (timesFile != NULL) fclose(timesFile);
+    timesFile = NULL;
+    capturing = false;
+
+    TraceLog(LOG_INFO, "CAPTURE: [%s] %u frames written, %u dropped", captureDirectory, framesWritten, framesDropped);
+    if (frameCount > 0) TraceLog(LOG_INFO, "CAPTURE: Main thread %.3f ms per frame, %.3f ms max", mainTime * 1000.0 / frameCount, mainMaxTime * 1000.0);
+#endif
+}
+
+bool IsCapturing(void)
+{
+#if defined(CAPTURE_SUPPORTED)
+    return capturing;
+#else
+    return false;
+#endif
+}
+
+void CaptureFrame(RenderTexture2D target)
+{
+#if defined(CAPTURE_SUPPORTED)
+    if (!capturing) return;
+
+    double start = GetMonotonicTime();
+
+    if ((frameWidth == 0) && !OpenCapture(target.texture.width, target.texture.height)) {
+        CloseCapture(false);
+        if (timesFile != NULL) fclose(timesFile);
+        timesFile = NULL;
+        capturing = false;
+        return;
+    }
+
+    // Reads that finished since the last frame, stopping at the first one still running
+    for (int i = 0; i < CAPTURE_PBO_COUNT; i++) {
+        CaptureBuffer *buffer = &buffers[(nextBuffer + i) % CAPTURE_PBO_COUNT];
+
+        if (!buffer->pending) continue;
+        if (!IsBufferReady(buffer)) break;
+        CollectBuffer(buffer, false);
+    }
+
+    CaptureBuffer *buffer = &buffers[nextBuffer];
+    if (buffer->pending) CollectBuffer(buffer, false);     // GPU a whole ring behind, waits
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer);
+    glReadPixels(0, 0, frameWidth, frameHeight, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    buffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    buffer->pending = true;
+    buffer->frame = frameCount++;
+    buffer->time = start - captureStart;
+    nextBuffer = (nextBuffer + 1) % CAPTURE_PBO_COUNT;
+
+    double elapsed = GetMonotonicTime() - start;
+    mainTime += elapsed;
+    if (elapsed > mainMaxTime) mainMaxTime = elapsed;
+#endif
+}
+
+void DrawCaptureStatus(int posX, int posY)
+{
+#if defined(CAPTURE_SUPPORTED)
+    if (!capturing) return;
+
+    DrawCircle(posX + 5, posY + 5, 5, RED);
+    if (framesDropped > 0) DrawText(TextFormat("REC %u, %u dropped", frameCount, framesDropped), posX + 14, posY, 10, RED);
+    else DrawText(TextFormat("REC %u", frameCount), posX + 14, posY, 10, RED);
+#endif
+}
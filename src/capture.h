@@ -0,0 +1,43 @@
+/**********************************************************************************************
+*
+*   Video Capture
+*
+*   Records the composed display target (native resolution, without the window-space
+*   overlays) as a numbered QOI image sequence, one directory per capture, with a
+*   frames.csv of capture times for performance sessions. Turn the sequence into a video
+*   with: ffmpeg -framerate 60 -i frame_%06d.qoi capture.mp4
+*
+*   The main thread never waits on the GPU: every frame is read into one of a ring of
+*   pixel buffer objects and mapped a couple of frames later, once its fence signaled;
+*   an encoder thread compresses and writes it. Frames are dropped, and counted, only
+*   when the encoder falls behind.
+*
+*   Needs OpenGL 3.3 on desktop Linux (the GL entry points come from libGL), elsewhere
+*   StartCapture() only logs a warning.
+*
+**********************************************************************************************/
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#define CAPTURE_PBO_COUNT 3                 // Frames in flight on the GPU
+#define CAPTURE_QUEUE_FRAMES 8              // Frames waiting for the encoder, power of two
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Capture Functions Declaration
+//----------------------------------------------------------------------------------
+bool StartCapture(const char *directory);           // New timestamped directory under directory
+void StopCapture(void);                             // Writes the frames in flight, before CloseWindow()
+bool IsCapturing(void);
+void CaptureFrame(RenderTexture2D target);          // Once per frame, after the target was drawn
+void DrawCaptureStatus(int posX, int posY);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAPTURE_H
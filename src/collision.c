@@ -0,0 +1,226 @@
+/**********************************************************************************************
+*
+*   Collision Grid Functions Definitions
+*
+*   Broadphase for moving objects: a uniform grid of COLLISION_CELL_SIZE cells over the
+*   room (objects outside are kept in the border cells). Each object is bucketed in every
+*   cell its bounds touch, laid out with a counting sort: per-cell counts, a prefix sum
+*   and one fill pass into a flat entries array, no per-cell lists. The counts are kept
+*   between updates and only touched for objects that changed cells.
+*
+*   Narrowphase tests the objects sharing a cell two by two. A pair sharing several cells
+*   is reported only from the cell holding the top-left corner of their overlap, so every
+*   pair comes out once, in cell then object order.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include <math.h>
+
+#define COLLISION_GRID_CELLS (ROOM_SIZE * TILE_SIZE / COLLISION_CELL_SIZE)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _CellRange {
+    short minX;                 // minX < 0 when the object is not in the grid
+    short minY;
+    short maxX;
+    short maxY;
+} CellRange;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int GetCell(float position)
+{
+    int cell = (int)(position / COLLISION_CELL_SIZE);
+    if (position < 0.0f) cell = 0;
+    if (cell > COLLISION_GRID_CELLS - 1) cell = COLLISION_GRID_CELLS - 1;
+    return cell;
+}
+
+// Last pixel the bounds cover, width - 1 like ReloadRoomTiles(): bounds ending on a cell
+// boundary stay out of the next cell. A partly covered pixel counts
+static float GetLastPixel(float start, float size)
+{
+    float last = ceilf(start + size) - 1.0f;
+    return (last < start) ? start : last;
+}
+
+static CellRange GetCellRange(Rectangle bounds)
+{
+    CellRange range = { (short)GetCell(bounds.x), (short)GetCell(bounds.y),
+                        (short)GetCell(GetLastPixel(bounds.x, bounds.width)), (short)GetCell(GetLastPixel(bounds.y, bounds.height)) };
+    return range;
+}
+
+static void CountRange(CollisionGrid *grid, CellRange range, int amount)
+{
+    if (range.minX < 0) return;
+
+    for (int y = range.minY; y <= range.maxY; y++) {
+        for (int x = range.minX; x <= range.maxX; x++) grid->cellCounts[y * COLLISION_GRID_CELLS + x] += amount;
+    }
+    grid->entryCount += amount * (range.maxX - range.minX + 1) * (range.maxY - range.minY + 1);
+}
+
+static bool Overlaps(Rectangle a, Rectangle b)
+{
+    return (a.x < b.x + b.width) && (b.x < a.x + a.width) && (a.y < b.y + b.height) && (b.y < a.y + a.height);
+}
+
+//----------------------------------------------------------------------------------
+// Collision Grid Functions Definition
+//----------------------------------------------------------------------------------
+CollisionGrid LoadCollisionGrid(int capacity)
+{
+    CollisionGrid grid = { 0 };
+    int cells = COLLISION_GRID_CELLS * COLLISION_GRID_CELLS;
+
+    grid.capacity = capacity;
+    grid.bounds = MemAllocTracked(capacity * sizeof(Rectangle), "collision bounds");
+    grid.ranges = MemAllocTracked(capacity * sizeof(CellRange), "collision ranges");
+    grid.stamps = MemAllocTracked(capacity * sizeof(unsigned int), "collision stamps");
+    grid.cellCounts = MemAllocTracked(cells * sizeof(int), "collision cells");
+    grid.cellStarts = MemAllocTracked((cells + 1) * sizeof(int), "collision cells");
+    grid.entryCapacity = capacity * 4;
+    grid.entries = MemAllocTracked(grid.entryCapacity * sizeof(int), "collision entries");
+    ClearCollisionGrid(&grid);
+
+    return grid;
+}
+
+void UnloadCollisionGrid(CollisionGrid grid)
+{
+    if (grid.bounds == NULL) return;
+
+    MemFreeTracked(grid.bounds);
+    MemFreeTracked(grid.ranges);
+    MemFreeTracked(grid.stamps);
+    MemFreeTracked(grid.cellCounts);
+    MemFreeTracked(grid.cellStarts);
+    MemFreeTracked(grid.entries);
+}
+
+void ClearCollisionGrid(CollisionGrid *grid)
+{
+    for (int i = 0; i < grid->capacity; i++) {
+        grid->ranges[i] = (CellRange){ -1, -1, -1, -1 };
+        grid->stamps[i] = 0;
+    }
+    for (int c = 0; c < COLLISION_GRID_CELLS * COLLISION_GRID_CELLS; c++) grid->cellCounts[c] = 0;
+    grid->objectCount = 0;
+    grid->entryCount = 0;
+    grid->stamp = 0;
+}
+
+void SetCollisionObject(CollisionGrid *grid, int object, Rectangle bounds)
+{
+    if ((object < 0) || (object >= grid->capacity)) return;
+
+    CellRange range = GetCellRange(bounds);
+    CellRange *previous = &grid->ranges[object];
+
+    grid->bounds[object] = bounds;
+    if ((range.minX != previous->minX) || (range.minY != previous->minY) || (range.maxX != previous->maxX) || (range.maxY != previous->maxY)) {
+        CountRange(grid, *previous, -1);
+        CountRange(grid, range, 1);
+        *previous = range;
+    }
+    if (object >= grid->objectCount) grid->objectCount = object + 1;
+}
+
+void RemoveCollisionObject(CollisionGrid *grid, int object)
+{
+    if ((object < 0) || (object >= grid->capacity)) return;
+
+    CountRange(grid, grid->ranges[object], -1);
+    grid->ranges[object] = (CellRange){ -1, -1, -1, -1 };
+}
+
+void UpdateCollisionGrid(CollisionGrid *grid)
+{
+    int cells = COLLISION_GRID_CELLS * COLLISION_GRID_CELLS;
+
+    // Big objects touch many cells, grow the entries instead of dropping them
+    if (grid->entryCount > grid->entryCapacity) {
+        MemFreeTracked(grid->entries);
+        grid->entryCapacity = grid->entryCount * 2;
+        grid->entries = MemAllocTracked(grid->entryCapacity * sizeof(int), "collision entries");
+    }
+
+    grid->cellStarts[0] = 0;
+    for (int c = 0; c < cells; c++) grid->cellStarts[c + 1] = grid->cellStarts[c] + grid->cellCounts[c];
+
+    // cellStarts[c] is the fill cursor of cell c, it ends at the start of c + 1 so one shift restores them
+    for (int i = 0; i < grid->objectCount; i++) {
+        CellRange range = grid->ranges[i];
+        if (range.minX < 0) continue;
+
+        for (int y = range.minY; y <= range.maxY; y++) {
+            for (int x = range.minX; x <= range.maxX; x++) grid->entries[grid->cellStarts[y * COLLISION_GRID_CELLS + x]++] = i;
+        }
+    }
+    for (int c = cells; c > 0; c--) grid->cellStarts[c] = grid->cellStarts[c - 1];
+    grid->cellStarts[0] = 0;
+}
+
+int FindCollisionPairs(const CollisionGrid *grid, CollisionPair *pairs, int maxPairs)
+{
+    int count = 0;
+
+    for (int c = 0; c < COLLISION_GRID_CELLS * COLLISION_GRID_CELLS; c++) {
+        int start = grid->cellStarts[c];
+        int end = grid->cellStarts[c + 1];
+
+        for (int i = start; i < end; i++) {
+            int a = grid->entries[i];
+            Rectangle boundsA = grid->bounds[a];
+
+            for (int j = i + 1; j < end; j++) {
+                int b = grid->entries[j];
+                Rectangle boundsB = grid->bounds[b];
+
+                if (!Overlaps(boundsA, boundsB)) continue;
+
+                // Only the cell holding the overlap's top-left corner reports the pair
+                float left = (boundsA.x > boundsB.x) ? boundsA.x : boundsB.x;
+                float top = (boundsA.y > boundsB.y) ? boundsA.y : boundsB.y;
+                if (GetCell(top) * COLLISION_GRID_CELLS + GetCell(left) != c) continue;
+
+                if (count < maxPairs) pairs[count] = (CollisionPair){ a, b };
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+int QueryCollisionGrid(CollisionGrid *grid, Rectangle area, int *objects, int maxObjects)
+{
+    CellRange range = GetCellRange(area);
+    int count = 0;
+
+    // Objects spanning several cells are seen once per cell, the stamp skips repeats
+    grid->stamp++;
+    for (int y = range.minY; y <= range.maxY; y++) {
+        for (int x = range.minX; x <= range.maxX; x++) {
+            int cell = y * COLLISION_GRID_CELLS + x;
+
+            for (int i = grid->cellStarts[cell]; i < grid->cellStarts[cell + 1]; i++) {
+                int object = grid->entries[i];
+
+                if ((grid->stamps[object] == grid->stamp) || !Overlaps(area, grid->bounds[object])) continue;
+                grid->stamps[object] = grid->stamp;
+                if (count < maxObjects) objects[count] = object;
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
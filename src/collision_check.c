@@ -0,0 +1,196 @@
+/**********************************************************************************************
+*
+*   Collision Grid Check
+*
+*   Randomized check of collision.c against brute force. Objects of random sizes are added,
+*   moved and removed across the room and past its edges, some on exact cell boundaries and
+*   some at fractional positions, and after every update the grid must report exactly the
+*   overlapping pairs a test of every pair finds, each once, a < b, and every query must
+*   return exactly the objects overlapping its area.
+*
+*   Build: make collision_check (plain C and raylib headers, no window or audio device)
+*
+*   Usage: ./collision_check [updates] [seed]
+*       Defaults: 20000 updates, seed 1. Exit code 1 on the first mismatch
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_OBJECTS 96
+#define CHECK_QUERIES 8
+#define CHECK_DEFAULT_UPDATES 20000
+#define CHECK_MAX_PAIRS (CHECK_OBJECTS * CHECK_OBJECTS / 2)
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static Rectangle bounds[CHECK_OBJECTS] = { 0 };
+static bool present[CHECK_OBJECTS] = { 0 };
+static unsigned char expected[CHECK_OBJECTS][CHECK_OBJECTS] = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Headless stand-ins for what the collision grid uses from memtrack.c
+void *MemAllocTracked(unsigned int size, const char *label)
+{
+    (void)label;
+    return malloc(size);
+}
+
+void MemFreeTracked(void *ptr)
+{
+    free(ptr);
+}
+
+static unsigned int NextRandom(unsigned int *seed)
+{
+    unsigned int x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// Whole cells, whole pixels or fractions, a little past the room on every side
+static float GetRandomCoordinate(unsigned int *seed)
+{
+    float room = (float)(ROOM_SIZE * TILE_SIZE);
+    unsigned int pick = NextRandom(seed) % 3;
+
+    if (pick == 0) return (float)((int)(NextRandom(seed) % (ROOM_SIZE + 3)) - 1) * COLLISION_CELL_SIZE;
+    if (pick == 1) return (float)((int)(NextRandom(seed) % (unsigned int)(room + 64)) - 32);
+    return (float)(NextRandom(seed) % 100000) / 100000.0f * (room + 64.0f) - 32.0f;
+}
+
+static Rectangle GetRandomBounds(unsigned int *seed)
+{
+    unsigned int pick = NextRandom(seed) % 16;
+    float size = (pick == 0) ? 8.0f * COLLISION_CELL_SIZE : ((pick < 4) ? 3.0f * COLLISION_CELL_SIZE : (float)COLLISION_CELL_SIZE);
+    float width = ((NextRandom(seed) % 3) == 0) ? (float)(1 + NextRandom(seed) % (unsigned int)size) : (float)(NextRandom(seed) % 100000) / 100000.0f * size + 0.25f;
+    float height = ((NextRandom(seed) % 3) == 0) ? (float)(1 + NextRandom(seed) % (unsigned int)size) : (float)(NextRandom(seed) % 100000) / 100000.0f * size + 0.25f;
+
+    return (Rectangle){ GetRandomCoordinate(seed), GetRandomCoordinate(seed), width, height };
+}
+
+static bool Overlaps(Rectangle a, Rectangle b)
+{
+    return (a.x < b.x + b.width) && (b.x < a.x + a.width) && (a.y < b.y + b.height) && (b.y < a.y + a.height);
+}
+
+static bool CheckPairs(const CollisionGrid *grid, int update)
+{
+    static CollisionPair pairs[CHECK_MAX_PAIRS];
+    int expectedCount = 0;
+
+    for (int a = 0; a < CHECK_OBJECTS; a++) {
+        for (int b = a + 1; b < CHECK_OBJECTS; b++) {
+            expected[a][b] = present[a] && present[b] && Overlaps(bounds[a], bounds[b]);
+            expectedCount += expected[a][b];
+        }
+    }
+
+    int count = FindCollisionPairs(grid, pairs, CHECK_MAX_PAIRS);
+    if (count != expectedCount) {
+        printf("FAIL update %i: %i pairs found, %i expected\n", update, count, expectedCount);
+        return false;
+    }
+    for (int p = 0; p < count; p++) {
+        int a = pairs[p].a;
+        int b = pairs[p].b;
+
+        if ((a < 0) || (a >= b) || (b >= CHECK_OBJECTS) || (expected[a][b] != 1)) {
+            printf("FAIL update %i: pair %i-%i is not overlapping or reported twice\n", update, a, b);
+            return false;
+        }
+        expected[a][b] = 2;
+    }
+    return true;
+}
+
+static bool CheckQuery(CollisionGrid *grid, Rectangle area, int update)
+{
+    int objects[CHECK_OBJECTS];
+    bool seen[CHECK_OBJECTS] = { 0 };
+    int expectedCount = 0;
+
+    for (int i = 0; i < CHECK_OBJECTS; i++) expectedCount += (present[i] && Overlaps(area, bounds[i]));
+
+    int count = QueryCollisionGrid(grid, area, objects, CHECK_OBJECTS);
+    if (count != expectedCount) {
+        printf("FAIL update %i: query found %i objects, %i expected\n", update, count, expectedCount);
+        return false;
+    }
+    for (int k = 0; k < count; k++) {
+        int i = objects[k];
+
+        if ((i < 0) || (i >= CHECK_OBJECTS) || seen[i] || !present[i] || !Overlaps(area, bounds[i])) {
+            printf("FAIL update %i: query returned object %i wrongly\n", update, i);
+            return false;
+        }
+        seen[i] = true;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Program main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int updates = (argc > 1) ? atoi(argv[1]) : CHECK_DEFAULT_UPDATES;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    long pairTotal = 0;
+
+    if (seed == 0) seed = 1;
+
+    // Entries start at four cells per object, the few room-sized objects make them grow
+    CollisionGrid grid = LoadCollisionGrid(CHECK_OBJECTS);
+
+    for (int u = 0; u < updates; u++) {
+        // Every so often start over, otherwise move, add or remove a share of the objects
+        if ((NextRandom(&seed) % 500) == 0) {
+            ClearCollisionGrid(&grid);
+            memset(present, 0, sizeof(present));
+        }
+
+        for (int i = 0; i < CHECK_OBJECTS; i++) {
+            unsigned int pick = NextRandom(&seed) % 10;
+
+            if (pick < 3) {
+                bounds[i] = GetRandomBounds(&seed);
+                present[i] = true;
+                SetCollisionObject(&grid, i, bounds[i]);
+            }
+            else if ((pick == 3) && present[i]) {
+                present[i] = false;
+                RemoveCollisionObject(&grid, i);
+            }
+            else if ((pick == 4) && present[i]) {
+                // Small step, often staying in the same cells
+                bounds[i].x += (float)((int)(NextRandom(&seed) % 9) - 4) * 0.5f;
+                bounds[i].y += (float)((int)(NextRandom(&seed) % 9) - 4) * 0.5f;
+                SetCollisionObject(&grid, i, bounds[i]);
+            }
+        }
+        UpdateCollisionGrid(&grid);
+
+        if (!CheckPairs(&grid, u)) return 1;
+        for (int q = 0; q < CHECK_QUERIES; q++) {
+            if (!CheckQuery(&grid, GetRandomBounds(&seed), u)) return 1;
+        }
+        pairTotal += FindCollisionPairs(&grid, NULL, 0);
+    }
+
+    printf("collision_check: %i updates of %i objects, %ld pairs: OK\n", updates, CHECK_OBJECTS, pairTotal);
+
+    UnloadCollisionGrid(grid);
+    return 0;
+}
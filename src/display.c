@@ -0,0 +1,123 @@
+/**********************************************************************************************
+*
+*   Display Functions Definitions
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "display.h"
+#include "memtrack.h"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static RenderTexture2D displayTarget = { 0 };
+static int displayWidth = 0;
+static int displayHeight = 0;
+static DisplayScaling displayScaling = DISPLAY_INTEGER;
+
+static RenderTexture2D targetStack[DISPLAY_MAX_TARGETS] = { 0 };
+static int targetDepth = 0;
+
+//----------------------------------------------------------------------------------
+// Display Functions Definition
+//----------------------------------------------------------------------------------
+void InitDisplay(int width, int height)
+{
+    displayWidth = width;
+    displayHeight = height;
+    displayTarget = LoadRenderTextureTracked(width, height);
+    SetTextureFilter(displayTarget.texture, TEXTURE_FILTER_POINT);
+}
+
+void UnloadDisplay(void)
+{
+    UnloadRenderTextureTracked(displayTarget);
+}
+
+void BeginDisplay(void)
+{
+    Rectangle rect = GetDisplayRect();
+
+    SetMouseOffset((int)-rect.x, (int)-rect.y);
+    SetMouseScale(displayWidth / rect.width, displayHeight / rect.height);
+
+    BeginDrawing();
+    targetDepth = 0;
+    PushRenderTarget(displayTarget);
+}
+
+void EndDisplay(void)
+{
+    PopRenderTarget();
+
+    ClearBackground(BLACK);
+    DrawTexturePro(displayTarget.texture, (Rectangle){ 0.0f, 0.0f, (float)displayWidth, (float)-displayHeight },
+                   GetDisplayRect(), (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+}
+
+int GetDisplayWidth(void)
+{
+    return displayWidth;
+}
+
+int GetDisplayHeight(void)
+{
+    return displayHeight;
+}
+
+RenderTexture2D GetDisplayTarget(void)
+{
+    return displayTarget;
+}
+
+Rectangle GetDisplayRect(void)
+{
+    float scaleX = (float)GetScreenWidth() / displayWidth;
+    float scaleY = (float)GetScreenHeight() / displayHeight;
+    float scale = (scaleX < scaleY) ? scaleX : scaleY;
+
+    // A window smaller than the display can only be fit
+    if ((displayScaling == DISPLAY_INTEGER) && (scale >= 1.0f)) scale = (float)(int)scale;
+
+    float width = displayWidth * scale;
+    float height = displayHeight * scale;
+
+    return (Rectangle){ (float)(int)((GetScreenWidth() - width) / 2), (float)(int)((GetScreenHeight() - height) / 2), width, height };
+}
+
+void SetDisplayScaling(DisplayScaling scaling)
+{
+    displayScaling = scaling;
+}
+
+DisplayScaling GetDisplayScaling(void)
+{
+    return displayScaling;
+}
+
+void SetWindowScale(int scale)
+{
+    if (scale < 1) scale = 1;
+    SetWindowSize(displayWidth * scale, displayHeight * scale);
+}
+
+void PushRenderTarget(RenderTexture2D target)
+{
+    if (targetDepth >= DISPLAY_MAX_TARGETS) {
+        TraceLog(LOG_WARNING, "DISPLAY: Render target stack full");
+        return;
+    }
+
+    targetStack[targetDepth++] = target;
+    BeginTextureMode(target);
+}
+
+void PopRenderTarget(void)
+{
+    if (targetDepth == 0) return;
+
+    EndTextureMode();
+    targetDepth--;
+    if (targetDepth > 0) BeginTextureMode(targetStack[targetDepth - 1]);
+}
@@ -0,0 +1,53 @@
+/**********************************************************************************************
+*
+*   Display
+*
+*   The game always renders into one fixed-size render texture (the resolution the art
+*   is drawn for) and that texture is blitted to the window with nearest-neighbor
+*   filtering, centered and letterboxed. Integer scaling keeps every texel the same
+*   size; fit scaling fills as much of the window as possible.
+*
+*   Screens draw in display coordinates: use GetDisplayWidth()/GetDisplayHeight()
+*   instead of GetScreenWidth()/GetScreenHeight(). Mouse input is mapped to display
+*   coordinates as well.
+*
+**********************************************************************************************/
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#define DISPLAY_MAX_TARGETS 4           // Render target nesting depth, display target included
+
+typedef enum _DisplayScaling {
+    DISPLAY_INTEGER,
+    DISPLAY_FIT
+} DisplayScaling;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Display Functions Declaration
+//----------------------------------------------------------------------------------
+void InitDisplay(int width, int height);            // After InitWindow()
+void UnloadDisplay(void);
+void BeginDisplay(void);                            // Replaces BeginDrawing()
+void EndDisplay(void);                              // Blit to the window, draw window-space overlays after, then EndDrawing()
+int GetDisplayWidth(void);
+int GetDisplayHeight(void);
+Rectangle GetDisplayRect(void);                     // Where the display lands in the window
+RenderTexture2D GetDisplayTarget(void);             // The composed frame, complete after EndDisplay()
+void SetDisplayScaling(DisplayScaling scaling);
+DisplayScaling GetDisplayScaling(void);
+void SetWindowScale(int scale);                     // Window size as a multiple of the display
+
+// Nestable BeginTextureMode()/EndTextureMode(), popping goes back to the enclosing target
+void PushRenderTarget(RenderTexture2D target);
+void PopRenderTarget(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_H
@@ -0,0 +1,227 @@
+/**********************************************************************************************
+*
+*   Batched Environment Functions Definitions
+*
+*   All instances live in one block after the batch header. Stepping only touches that
+*   block and the caller's arrays. With threads > 1 the batch owns a small persistent
+*   pool: every StepEnvBatch() call wakes the workers, each one steps a contiguous slice
+*   and the calling thread steps the first slice itself.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "env.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+// Observation layout in env.h is written against a 10x10 room
+typedef char EnvRoomCellsCheck[(ENV_ROOM_CELLS == ROOM_SIZE * ROOM_SIZE) ? 1 : -1];
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _EnvInstance {
+    GameState state;
+    int ticks;
+} EnvInstance;
+
+typedef struct _EnvWorker {
+    EnvBatch *batch;
+    int index;
+} EnvWorker;
+
+struct _EnvBatch {
+    int count;
+    int maxTicks;
+    int threads;
+
+    pthread_t threadIds[ENV_MAX_THREADS];
+    EnvWorker workers[ENV_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned int generation;
+    int pending;
+    bool quit;
+
+    // Arrays of the step in flight, only valid while workers are pending
+    const int *actions;
+    float *observations;
+    float *rewards;
+    unsigned char *dones;
+
+    EnvInstance instances[];
+};
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void WriteObservation(const EnvInstance *instance, float *observation)
+{
+    const GameState *state = &instance->state;
+    const TileType *tiles = &state->room.tiles[0][0];
+
+    for (int i = 0; i < ENV_ROOM_CELLS; i++) observation[i] = (float)tiles[i];
+    observation[ENV_ROOM_CELLS + 0] = FIXED_TO_FLOAT(state->player.position.x) / (ROOM_SIZE * TILE_SIZE);
+    observation[ENV_ROOM_CELLS + 1] = FIXED_TO_FLOAT(state->player.position.y) / (ROOM_SIZE * TILE_SIZE);
+    observation[ENV_ROOM_CELLS + 2] = (float)state->rotations;
+    observation[ENV_ROOM_CELLS + 3] = (float)state->player.oxygen / GetSimulationMaxOxygen();
+}
+
+static void ResetInstance(EnvInstance *instance, int room)
+{
+    GameState *state = &instance->state;
+
+    state->player = GetDefaultPlayer();
+    state->rotations = 0;
+    LoadRoom(state, room);
+    instance->ticks = 0;
+}
+
+static void StepSlice(EnvBatch *batch, int worker)
+{
+    int slice = (batch->count + batch->threads - 1) / batch->threads;
+    int first = worker * slice;
+    int count = batch->count - first;
+
+    if (count > slice) count = slice;
+    if (count > 0) StepEnvRange(batch, first, count, batch->actions, batch->observations, batch->rewards, batch->dones);
+}
+
+static void *RunEnvWorker(void *data)
+{
+    EnvWorker *worker = (EnvWorker *)data;
+    EnvBatch *batch = worker->batch;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&batch->lock);
+    for (;;) {
+        while (!batch->quit && (batch->generation == seen)) pthread_cond_wait(&batch->wake, &batch->lock);
+        if (batch->quit) break;
+        seen = batch->generation;
+        pthread_mutex_unlock(&batch->lock);
+
+        StepSlice(batch, worker->index);
+
+        pthread_mutex_lock(&batch->lock);
+        if (--batch->pending == 0) pthread_cond_signal(&batch->done);
+    }
+    pthread_mutex_unlock(&batch->lock);
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Batched Environment Functions Definition
+//----------------------------------------------------------------------------------
+EnvBatch *LoadEnvBatch(int count, int threads, int maxTicks, unsigned int seed)
+{
+    if (count <= 0) return NULL;
+    if (threads < 1) threads = 1;
+    if (threads > ENV_MAX_THREADS) threads = ENV_MAX_THREADS;
+    if (threads > count) threads = count;
+
+    EnvBatch *batch = (EnvBatch *)calloc(1, sizeof(EnvBatch) + (size_t)count * sizeof(EnvInstance));
+    if (batch == NULL) return NULL;
+
+    batch->count = count;
+    batch->maxTicks = (maxTicks > 0) ? maxTicks : 60 * 60;
+    batch->threads = threads;
+
+    for (int i = 0; i < count; i++) {
+        batch->instances[i].state.seed = seed ^ ((unsigned int)i * 2654435761u);
+        ResetInstance(&batch->instances[i], i % NUM_ROOMS);
+    }
+
+    pthread_mutex_init(&batch->lock, NULL);
+    pthread_cond_init(&batch->wake, NULL);
+    pthread_cond_init(&batch->done, NULL);
+    for (int t = 1; t < threads; t++) {
+        batch->workers[t] = (EnvWorker){ batch, t };
+        pthread_create(&batch->threadIds[t], NULL, RunEnvWorker, &batch->workers[t]);
+    }
+
+    return batch;
+}
+
+void UnloadEnvBatch(EnvBatch *batch)
+{
+    if (batch == NULL) return;
+
+    pthread_mutex_lock(&batch->lock);
+    batch->quit = true;
+    pthread_cond_broadcast(&batch->wake);
+    pthread_mutex_unlock(&batch->lock);
+    for (int t = 1; t < batch->threads; t++) pthread_join(batch->threadIds[t], NULL);
+
+    pthread_cond_destroy(&batch->done);
+    pthread_cond_destroy(&batch->wake);
+    pthread_mutex_destroy(&batch->lock);
+    free(batch);
+}
+
+int GetEnvBatchCount(const EnvBatch *batch)
+{
+    return batch->count;
+}
+
+void ResetEnvBatch(EnvBatch *batch, float *observations)
+{
+    for (int i = 0; i < batch->count; i++) {
+        EnvInstance *instance = &batch->instances[i];
+        ResetInstance(instance, instance->state.currentRoom);
+        WriteObservation(instance, observations + (size_t)i * ENV_OBSERVATION_SIZE);
+    }
+}
+
+void StepEnvRange(EnvBatch *batch, int first, int count, const int *actions, float *observations, float *rewards, unsigned char *dones)
+{
+    for (int i = first; i < first + count; i++) {
+        EnvInstance *instance = &batch->instances[i];
+        int events = UpdateGameState(&instance->state, actions[i]);
+        float reward = 0.0f;
+        bool done = false;
+
+        instance->ticks++;
+        if (events & EVENT_EXIT) {
+            // The simulation already moved on, the next episode starts in that room
+            reward = 1.0f;
+            done = true;
+            ResetInstance(instance, instance->state.currentRoom);
+        }
+        else if ((events & EVENT_DEATH) || (instance->ticks >= batch->maxTicks)) {
+            reward = (events & EVENT_DEATH) ? -1.0f : 0.0f;
+            done = true;
+            ResetInstance(instance, instance->state.currentRoom);
+        }
+
+        rewards[i] = reward;
+        dones[i] = done;
+        WriteObservation(instance, observations + (size_t)i * ENV_OBSERVATION_SIZE);
+    }
+}
+
+void StepEnvBatch(EnvBatch *batch, const int *actions, float *observations, float *rewards, unsigned char *dones)
+{
+    if (batch->threads <= 1) {
+        StepEnvRange(batch, 0, batch->count, actions, observations, rewards, dones);
+        return;
+    }
+
+    pthread_mutex_lock(&batch->lock);
+    batch->actions = actions;
+    batch->observations = observations;
+    batch->rewards = rewards;
+    batch->dones = dones;
+    batch->pending = batch->threads - 1;
+    batch->generation++;
+    pthread_cond_broadcast(&batch->wake);
+    pthread_mutex_unlock(&batch->lock);
+
+    StepSlice(batch, 0);
+
+    pthread_mutex_lock(&batch->lock);
+    while (batch->pending > 0) pthread_cond_wait(&batch->done, &batch->lock);
+    pthread_mutex_unlock(&batch->lock);
+}
@@ -0,0 +1,50 @@
+/**********************************************************************************************
+*
+*   Batched Environment API
+*
+*   C API to train control policies against the game. A batch holds N independent game
+*   instances in one allocation and steps all of them with one call on an action array.
+*   Observations, rewards and done flags are written straight into caller-owned arrays,
+*   stepping never allocates.
+*
+*   Observation layout, ENV_OBSERVATION_SIZE floats per instance, instance i starting at
+*   observations[i*ENV_OBSERVATION_SIZE]:
+*       [0, ROOM_CELLS)     Tile grid row by row, TileType values
+*       ROOM_CELLS + 0      Player x, 0..1 across the room
+*       ROOM_CELLS + 1      Player y, 0..1 across the room
+*       ROOM_CELLS + 2      Room orientation, 0..3 quarter turns
+*       ROOM_CELLS + 3      Oxygen, 0..1
+*
+*   Actions are GameInput flags: 0 none, 1 left, 2 right, 4 rotate (may be or-ed).
+*   Rewards: +1 on exit, -1 on death (hazard or oxygen), 0 otherwise. An instance is done
+*   on exit, death or after maxTicks, and is reset with LoadRoom() before the next step.
+*
+**********************************************************************************************/
+
+#ifndef ENV_H
+#define ENV_H
+
+#define ENV_ROOM_CELLS 100                          // ROOM_SIZE*ROOM_SIZE
+#define ENV_OBSERVATION_SIZE (ENV_ROOM_CELLS + 4)
+#define ENV_MAX_THREADS 64
+
+typedef struct _EnvBatch EnvBatch;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+EnvBatch *LoadEnvBatch(int count, int threads, int maxTicks, unsigned int seed);  // threads <= 1 steps on the caller
+void UnloadEnvBatch(EnvBatch *batch);
+int GetEnvBatchCount(const EnvBatch *batch);
+void ResetEnvBatch(EnvBatch *batch, float *observations);
+void StepEnvBatch(EnvBatch *batch, const int *actions, float *observations, float *rewards, unsigned char *dones);
+
+// Step instances [first, first + count) only, for callers running their own thread pool
+void StepEnvRange(EnvBatch *batch, int first, int count, const int *actions, float *observations, float *rewards, unsigned char *dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENV_H
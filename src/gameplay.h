@@ -0,0 +1,338 @@
+/**********************************************************************************************
+*
+*   Gameplay shared types and module declarations
+*
+*   Types used by the gameplay screen and by the modules that need to read or restore
+*   its state (simulation, rewind buffer, playtest harness) plus input, sprite animation,
+*   tile drawing, lighting, particles and room thumbnails
+*
+**********************************************************************************************/
+
+#ifndef GAMEPLAY_H
+#define GAMEPLAY_H
+
+#include "rooms.h"
+
+#define MAX_OXYGEN 100
+#define OXYGEN_DRAIN 10         // Oxygen units lost per second
+#define BACKGROUND_SIZE 64
+#define BACKGROUND_TILES (ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE)
+#define GETUP_TIME 0.75f        // Seconds spent GROUNDED before going back to IDLE
+#define GETUP_TICKS 45          // GETUP_TIME in simulation ticks
+#define SIM_TICK_RATE 60
+#define SIM_TICK_TIME (1.0f / SIM_TICK_RATE)
+#define ANIMATION_MAX_FRAMES 16
+#define MAX_PARTICLES 131072
+#define OXYGEN_WARNING 30       // Oxygen percentage that raises EVENT_OXYGEN_LOW
+
+// The simulation counts positions, speeds and oxygen in integer fixed point units, so
+// every platform gets bit-identical states. Floats only come out of it for drawing
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED(n) ((n) * FIXED_ONE)                  // Whole pixels or oxygen units to fixed point
+#define FIXED_TO_FLOAT(n) ((float)(n) / FIXED_ONE)  // Never fed back into the simulation
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4    // Delays up to 2^24 ticks, ~77 hours at 60 ticks per second
+#define TIMER_MAX_CAPACITY 65535
+#define COLLISION_CELL_SIZE TILE_SIZE   // Broadphase cells, must divide the room size
+#define THUMBNAIL_SIZE 64       // Room thumbnails are square, in pixels
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Fixed point pixels, FIXED_ONE per pixel
+typedef struct _FixedVector2 {
+    int x;
+    int y;
+} FixedVector2;
+
+typedef struct _Room {
+    TileType tiles[ROOM_SIZE][ROOM_SIZE];
+    Vector2 start;
+    int background[BACKGROUND_TILES][BACKGROUND_TILES];
+} Room;
+
+typedef enum _PlayerState {
+    IDLE,
+    FALL,
+    WALKING,
+    GROUNDED,
+    ROTATING
+} PlayerState;
+
+typedef enum _PlayerDirection {
+    RIGHT = 1,
+    LEFT = -1
+} PlayerDirection;
+
+typedef struct _Player {
+    FixedVector2 position;
+    FixedVector2 velocity;      // Fixed point pixels per tick
+    PlayerState state;
+    PlayerDirection direction;
+    int width;                  // Pixels
+    int height;
+    int oxygen;                 // Fixed point oxygen units
+    int stateTicks;             // Ticks spent in the current state
+} Player;
+
+// Everything needed to put the gameplay screen back to a given tick
+typedef struct _GameState {
+    Player player;
+    Room room;
+    int rotations;
+    int currentRoom;
+    int nextRoom;
+    unsigned int seed;          // Background randomization, advanced by LoadRoom
+} GameState;
+
+// Input flags consumed by one simulation tick
+typedef enum _GameInput {
+    INPUT_NONE = 0,
+    INPUT_LEFT = 1,
+    INPUT_RIGHT = 2,
+    INPUT_ROTATE = 4,
+    INPUT_REWIND = 8            // Held, steps the rewind buffer back instead of simulating
+} GameInput;
+
+// Event flags reported by one simulation tick
+typedef enum _GameEvent {
+    EVENT_NONE = 0,
+    EVENT_GROUNDED = 1,
+    EVENT_FALLING = 2,
+    EVENT_ROTATED = 4,
+    EVENT_EXIT = 8,
+    EVENT_DEATH_HAZARD = 16,
+    EVENT_DEATH_OXYGEN = 32,
+    EVENT_OXYGEN_LOW = 64       // Scheduled by the simulation thread, never by UpdateGameState()
+} GameEvent;
+
+#define EVENT_DEATH (EVENT_DEATH_HAZARD | EVENT_DEATH_OXYGEN)
+#define GAME_EVENT_KINDS 7      // GameEvent bits
+
+// Input latency mode stats, milliseconds
+typedef struct _InputLatency {
+    int count;                  // Presses measured, 0 while the mode is off
+    float min;
+    float avg;
+    float max;
+} InputLatency;
+
+// Read-only view of the simulation published once per tick
+typedef struct _GameSnapshot {
+    GameState state;
+    unsigned int tick;
+    unsigned int eventCounts[GAME_EVENT_KINDS];     // Ticks that reported each GameEvent bit so far
+    unsigned int rewindTicks;                       // Ticks that stepped back instead of forward so far
+    Vector2 deathPosition;                          // Where the player was at the last death
+    InputLatency inputLatency;                      // Measured by the thread consuming input
+} GameSnapshot;
+
+// Pending timers of one wheel, see timers.c. Handles are 0 when invalid
+typedef unsigned int TimerHandle;
+
+typedef struct _TimerEvent {
+    int action;
+    int data;
+    unsigned int tick;          // Tick the timer was due
+} TimerEvent;
+
+typedef struct _TimerWheel {
+    unsigned int tick;          // Ticks advanced so far
+    int capacity;
+    int count;
+    struct _TimerNode *nodes;
+    int freeHead;
+    int expiredHead;
+    int expiredTail;
+    int heads[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    int tails[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} TimerWheel;
+
+// Two overlapping objects of a collision grid, a < b
+typedef struct _CollisionPair {
+    int a;
+    int b;
+} CollisionPair;
+
+// Moving objects bucketed by cell, objects are indices below capacity
+typedef struct _CollisionGrid {
+    int capacity;
+    int objectCount;            // Highest object set plus one
+    Rectangle *bounds;
+    struct _CellRange *ranges;  // Cells each object was counted in
+    unsigned int *stamps;       // Last query that returned each object
+    unsigned int stamp;
+    int *cellCounts;
+    int *cellStarts;            // Prefix sums of cellCounts, one extra at the end
+    int *entries;               // Object indices grouped by cell
+    int entryCount;
+    int entryCapacity;
+} CollisionGrid;
+
+typedef enum _AnimationLoop {
+    ANIMATION_LOOP,
+    ANIMATION_ONCE              // Holds the last frame
+} AnimationLoop;
+
+// Sprite sheet clip, frames laid out left to right. Source rects for both facings
+// are filled by InitAnimationClip() once the sheet is loaded
+typedef struct _AnimationClip {
+    const Texture2D *sheet;
+    int frameCount;
+    float frameTime;            // Seconds per frame
+    AnimationLoop loop;
+    Rectangle frames[2][ANIMATION_MAX_FRAMES];      // [facing left][frame]
+} AnimationClip;
+
+typedef struct _Animator {
+    const AnimationClip *clip;
+    int frame;
+    float elapsed;              // Seconds into the current frame
+} Animator;
+
+typedef enum _ParticleEffect {
+    PARTICLES_DUST,             // Landing
+    PARTICLES_DEBRIS,           // Falling from the ceiling on rotation
+    PARTICLES_DEATH,
+    PARTICLES_OXYGEN            // Bubbles lost while oxygen runs low
+} ParticleEffect;
+
+typedef enum _LightingDetail {
+    LIGHTING_OFF,               // Drawn unlit, no extra pass
+    LIGHTING_COARSE,            // One lightmap texel per tile
+    LIGHTING_FULL
+} LightingDetail;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Declaration
+//----------------------------------------------------------------------------------
+void SetSimulationOxygen(float max, float drain);       // Units and units per second (up to 32767), shared by all states, set before simulating
+int GetSimulationMaxOxygen(void);                       // Fixed point
+int GetSimulationOxygenDrain(void);                     // Fixed point, per tick
+int GetSimulationOxygenWarning(void);                   // Fixed point, oxygen at or below it is low
+Player GetDefaultPlayer(void);                          // Full oxygen, LoadRoom() puts it at the start
+Vector2 GetPlayerPosition(const Player *player);        // Pixels, for drawing
+bool IsSolid(TileType tile);
+bool IsDeath(TileType tile);
+void LoadRoom(GameState *state, int room_num);
+bool LoadRoomFile(int room_num, const char *fileName);  // Replaces a built-in room, only while nothing simulates
+void SetRoomTiles(int room_num, const TileType tiles[ROOM_SIZE][ROOM_SIZE]);   // Same, tiles from memory
+int GetRoomCount(void);
+Room GetRoomLayout(int room_num);                       // Tiles as loaded, unrotated, no background
+void ReloadRoomTiles(GameState *state);                 // Current room from its (re)loaded tiles, keeps rotation and player
+void RotateRoom(GameState *state);
+int UpdateGameState(GameState *state, int input);       // One SIM_TICK_TIME tick, returns GameEvent flags
+
+//----------------------------------------------------------------------------------
+// Simulation Thread Functions Declaration
+//----------------------------------------------------------------------------------
+void StartSimulationThread(const GameState *state);     // Copies the state, rewind buffer and respawn point must be set
+void StopSimulationThread(void);
+void UpdateSimulationThread(void);                      // Once per frame, runs due ticks here when there is no thread
+void SetSimulationStepped(bool stepped);                // Before starting: no thread, exactly one tick per update
+const GameSnapshot *AcquireSnapshot(void);              // Latest snapshot, valid until the next call
+
+//----------------------------------------------------------------------------------
+// Timer Wheel Functions Declaration
+//----------------------------------------------------------------------------------
+TimerWheel LoadTimerWheel(int capacity);                // Up to TIMER_MAX_CAPACITY pending timers
+void UnloadTimerWheel(TimerWheel wheel);
+void ClearTimerWheel(TimerWheel *wheel);                // Cancel every timer, the tick keeps counting
+TimerHandle ScheduleTimer(TimerWheel *wheel, unsigned int delay, int action, int data);  // Due delay ticks from now, 0 when full
+bool CancelTimer(TimerWheel *wheel, TimerHandle handle);   // False once popped or cancelled
+void AdvanceTimerWheel(TimerWheel *wheel);              // One tick, due timers move to the expired list
+bool PopExpiredTimer(TimerWheel *wheel, TimerEvent *event); // In due order, the same for the same calls
+
+//----------------------------------------------------------------------------------
+// Collision Grid Functions Declaration
+//----------------------------------------------------------------------------------
+CollisionGrid LoadCollisionGrid(int capacity);
+void UnloadCollisionGrid(CollisionGrid grid);
+void ClearCollisionGrid(CollisionGrid *grid);           // Remove every object
+void SetCollisionObject(CollisionGrid *grid, int object, Rectangle bounds);    // Add or move, world units
+void RemoveCollisionObject(CollisionGrid *grid, int object);
+void UpdateCollisionGrid(CollisionGrid *grid);          // Rebucket after the objects moved, once per tick
+int FindCollisionPairs(const CollisionGrid *grid, CollisionPair *pairs, int maxPairs);  // Returns all pairs, fills up to maxPairs
+int QueryCollisionGrid(CollisionGrid *grid, Rectangle area, int *objects, int maxObjects); // Objects overlapping area (player vs objects)
+
+//----------------------------------------------------------------------------------
+// Input Functions Declaration
+//----------------------------------------------------------------------------------
+void PollGameInput(void);                               // Queue key changes, once per frame after raylib polled
+void ClearGameInput(void);                              // Drop queued events, only while no tick consumes
+int ConsumeGameInput(double tickTime);                  // GameInput flags for the tick at tickTime (GetTime() clock)
+void SetScriptedGameInput(int input);                   // GameInput flags every tick gets instead of the keys, -1 back to the keys
+void SetInputLatencyMode(bool enabled);                 // Render thread, disabling logs the last stats shown
+bool IsInputLatencyMode(void);
+void MarkInputResponse(bool stateChanged);              // Consumer thread, after each tick, whether input changed the game
+InputLatency GetInputLatency(void);                     // Consumer thread, for the snapshot
+void UpdateInputLatency(InputLatency latency);          // Render thread, stats of the latest snapshot
+void DrawInputLatency(int posX, int posY);
+
+//----------------------------------------------------------------------------------
+// Animation Functions Declaration
+//----------------------------------------------------------------------------------
+void InitAnimationClip(AnimationClip *clip);
+void PlayAnimation(Animator *animator, const AnimationClip *clip);  // Restarts only if the clip changes
+void UpdateAnimation(Animator *animator, float dt);
+void DrawAnimation(const Animator *animator, Vector2 position, PlayerDirection direction, Color tint);
+
+//----------------------------------------------------------------------------------
+// Tilemap Functions Declaration
+//----------------------------------------------------------------------------------
+void SetTileSheets(const Texture2D *ground, const Texture2D *stalagmite, const Texture2D *stalactite);
+void ResetTileCache(void);
+void UpdateTileCache(const Room *room, int rotations);  // Rebuilds only when the tiles changed
+void DrawTiles(void);
+
+//----------------------------------------------------------------------------------
+// Lighting Functions Declaration
+//----------------------------------------------------------------------------------
+void InitLighting(void);
+void UnloadLighting(void);
+void SetLightingDetail(LightingDetail detail);          // Any time, kept across InitLighting()
+void UpdateLighting(const GameState *state);            // Refill the lightmap, once per tick
+void BeginLighting(void);                               // Draw the world between begin and end
+void EndLighting(void);
+
+//----------------------------------------------------------------------------------
+// Room Thumbnail Functions Declaration
+//----------------------------------------------------------------------------------
+void InitRoomThumbnails(void);                          // Nothing is rendered until rooms are asked for
+void UnloadRoomThumbnails(void);                        // Before another screen sets the tile sheets
+void UpdateRoomThumbnails(int first, int count);        // Rooms about to be drawn, a few more get ready every call
+bool DrawRoomThumbnail(int room, Vector2 position);     // False and nothing drawn until ready
+
+//----------------------------------------------------------------------------------
+// Particle Functions Declaration
+//----------------------------------------------------------------------------------
+void ClearParticles(void);
+void SetParticleBudget(int budget);                     // Live particle limit, up to MAX_PARTICLES
+int GetParticleCount(void);
+int EmitParticles(ParticleEffect effect, Rectangle area, int count);    // count <= 0 uses the effect default, returns emitted
+void EmitGameParticles(const GameState *state, int events, float dt);   // Effects for one tick's GameEvent flags, not the death burst
+void UpdateParticles(float dt);
+void DrawParticles(void);                               // One batch, call inside BeginLighting/EndLighting
+
+//----------------------------------------------------------------------------------
+// Rewind Buffer Functions Declaration
+//----------------------------------------------------------------------------------
+void ResetRewindBuffer(void);
+void RecordRewindFrame(const GameState *state);      // Append one tick, call once per update
+bool RewindFrame(GameState *state);                  // Drop newest tick and restore the one before it
+int GetRewindFrameCount(void);
+void SetRespawnPoint(const GameState *state);        // Pin the state restored on death
+void RestoreRespawnPoint(GameState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAMEPLAY_H
@@ -0,0 +1,198 @@
+/**********************************************************************************************
+*
+*   Hot Reload Functions Definitions
+*
+*   The watcher blocks in poll() on the inotify descriptor, with a timeout so it notices
+*   CloseHotReload(). Changed paths go through a single producer / single consumer ring
+*   of fixed-size names; a path already waiting in the ring is not queued twice, editors
+*   often write a file in several steps.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "hotreload.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(HOT_RELOAD) && defined(__linux__) && !defined(PLATFORM_WEB)
+    #define HOTRELOAD_SUPPORTED
+    #include <pthread.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <dirent.h>
+    #include <sys/inotify.h>
+#endif
+
+#define HOTRELOAD_QUEUE_SIZE 32             // Power of two
+#define HOTRELOAD_MAX_PATH 256
+#define HOTRELOAD_MAX_WATCHES 16
+#define HOTRELOAD_POLL_TIMEOUT 100          // Milliseconds
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static char queue[HOTRELOAD_QUEUE_SIZE][HOTRELOAD_MAX_PATH] = { 0 };
+static unsigned int queueHead = 0;          // Written by the watcher only
+static unsigned int queueTail = 0;          // Written by the game thread only
+static char reloadedFile[HOTRELOAD_MAX_PATH] = { 0 };
+
+#if defined(HOTRELOAD_SUPPORTED)
+static int notifyFd = -1;
+static int watchIds[HOTRELOAD_MAX_WATCHES] = { 0 };
+static char watchPaths[HOTRELOAD_MAX_WATCHES][HOTRELOAD_MAX_PATH] = { 0 };
+static int watchCount = 0;
+
+static pthread_t watcher;
+static bool watcherRunning = false;
+static bool watcherQuit = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(HOTRELOAD_SUPPORTED)
+static void AddWatch(const char *path)
+{
+    if ((watchCount >= HOTRELOAD_MAX_WATCHES) || (strlen(path) >= HOTRELOAD_MAX_PATH)) return;
+
+    int id = inotify_add_watch(notifyFd, path, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (id < 0) return;
+
+    watchIds[watchCount] = id;
+    snprintf(watchPaths[watchCount], HOTRELOAD_MAX_PATH, "%s", path);
+    watchCount++;
+}
+
+static void QueueFile(const char *directory, const char *name)
+{
+    char path[HOTRELOAD_MAX_PATH];
+    unsigned int tail = __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+
+    // A truncated path could name some other file, longer ones are not queued
+    int length = snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if ((length < 0) || (length >= (int)sizeof(path))) return;
+
+    // Entries between tail and head are not touched by the game thread until consumed
+    for (unsigned int i = tail; i != queueHead; i++) {
+        if (strcmp(queue[i & (HOTRELOAD_QUEUE_SIZE - 1)], path) == 0) return;
+    }
+    if (queueHead - tail >= HOTRELOAD_QUEUE_SIZE) return;
+
+    snprintf(queue[queueHead & (HOTRELOAD_QUEUE_SIZE - 1)], HOTRELOAD_MAX_PATH, "%s", path);
+    __atomic_store_n(&queueHead, queueHead + 1, __ATOMIC_RELEASE);
+}
+
+static void *RunWatcher(void *data)
+{
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd descriptor = { notifyFd, POLLIN, 0 };
+
+    while (!__atomic_load_n(&watcherQuit, __ATOMIC_ACQUIRE)) {
+        if (poll(&descriptor, 1, HOTRELOAD_POLL_TIMEOUT) <= 0) continue;
+
+        ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+        for (char *cursor = buffer; (length > 0) && (cursor < buffer + length); ) {
+            const struct inotify_event *event = (const struct inotify_event *)cursor;
+
+            if ((event->len > 0) && !(event->mask & IN_ISDIR)) {
+                for (int w = 0; w < watchCount; w++) {
+                    if (watchIds[w] == event->wd) QueueFile(watchPaths[w], event->name);
+                }
+            }
+            cursor += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Hot Reload Functions Definition
+//----------------------------------------------------------------------------------
+void InitHotReload(const char *directory)
+{
+#if defined(HOTRELOAD_SUPPORTED)
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd < 0) {
+        TraceLog(LOG_WARNING, "HOTRELOAD: inotify not available, assets are not watched");
+        return;
+    }
+
+    AddWatch(directory);
+
+    DIR *dir = opendir(directory);
+    if (dir != NULL) {
+        struct dirent *entry = NULL;
+        char path[HOTRELOAD_MAX_PATH];
+
+        while ((entry = readdir(dir)) != NULL) {
+            if ((entry->d_type != DT_DIR) || (entry->d_name[0] == '.')) continue;
+            int length = snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+            if ((length > 0) && (length < (int)sizeof(path))) AddWatch(path);
+            else TraceLog(LOG_WARNING, "HOTRELOAD: [%s/%s] Path too long, not watched", directory, entry->d_name);
+        }
+        closedir(dir);
+    }
+
+    watcherQuit = false;
+    watcherRunning = (pthread_create(&watcher, NULL, RunWatcher, NULL) == 0);
+    TraceLog(LOG_INFO, "HOTRELOAD: Watching %i directories under %s", watchCount, directory);
+#endif
+}
+
+void CloseHotReload(void)
+{
+#if defined(HOTRELOAD_SUPPORTED)
+    if (watcherRunning) {
+        __atomic_store_n(&watcherQuit, true, __ATOMIC_RELEASE);
+        pthread_join(watcher, NULL);
+        watcherRunning = false;
+    }
+    if (notifyFd >= 0) close(notifyFd);
+    notifyFd = -1;
+    watchCount = 0;
+#endif
+}
+
+const char *GetReloadedFile(void)
+{
+    unsigned int tail = queueTail;
+
+    if (tail == __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE)) return NULL;
+
+    snprintf(reloadedFile, sizeof(reloadedFile), "%s", queue[tail & (HOTRELOAD_QUEUE_SIZE - 1)]);
+    __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+    return reloadedFile;
+}
+
+bool ReloadTexture(Texture2D *texture, const char *fileName)
+{
+    Image image = LoadImageTracked(fileName);
+    if (image.data == NULL) return false;
+
+    if ((image.width == texture->width) && (image.height == texture->height) && (image.format == texture->format) && (image.mipmaps == 1)) {
+        UpdateTexture(*texture, image.data);
+    }
+    else {
+        UnloadTextureTracked(*texture);
+        *texture = LoadTextureFromImageTracked(image);
+    }
+
+    UnloadImageTracked(image);
+    TraceLog(LOG_INFO, "HOTRELOAD: [%s] Texture reloaded", fileName);
+    return true;
+}
+
+bool ReloadSound(Sound *sound, const char *fileName)
+{
+    Sound reloaded = LoadSoundTracked(fileName);
+    if (reloaded.stream.buffer == NULL) return false;
+
+    StopSound(*sound);
+    UnloadSoundTracked(*sound);
+    *sound = reloaded;
+    TraceLog(LOG_INFO, "HOTRELOAD: [%s] Sound reloaded", fileName);
+    return true;
+}
@@ -0,0 +1,40 @@
+/**********************************************************************************************
+*
+*   Hot Reload
+*
+*   A background thread watches a resources directory (and its direct subdirectories)
+*   with inotify and queues the path of every file written or moved in, the same path
+*   the game loads it from (e.g. "resources/art/Miner_Idle-Sheet.png"). The screen that
+*   owns the asset pulls the queued paths once per frame and reloads just those.
+*
+*   Textures are reloaded in place: same size and format only uploads the new pixels,
+*   otherwise the texture is recreated into the same Texture2D, so pointers to it stay
+*   valid either way.
+*
+*   Off by default, build with HOT_RELOAD=TRUE (-DHOT_RELOAD). Only on Linux desktop builds,
+*   elsewhere nothing is ever queued.
+*
+**********************************************************************************************/
+
+#ifndef HOTRELOAD_H
+#define HOTRELOAD_H
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Hot Reload Functions Declaration
+//----------------------------------------------------------------------------------
+void InitHotReload(const char *directory);          // Watches directory and its subdirectories
+void CloseHotReload(void);
+const char *GetReloadedFile(void);                  // Next changed path or NULL, valid until the next call
+
+bool ReloadTexture(Texture2D *texture, const char *fileName);
+bool ReloadSound(Sound *sound, const char *fileName);   // Volume goes back to default, set it again
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOTRELOAD_H
@@ -0,0 +1,262 @@
+/**********************************************************************************************
+*
+*   Input Functions Definitions
+*
+*   Key changes are turned into timestamped events in a ring buffer as soon as raylib
+*   has polled the OS, and every simulation tick folds the events up to its own time
+*   into GameInput flags. Presses come from raylib's key queue, so two presses of the
+*   same key in one frame, or a press released before the frame ends, are kept.
+*
+*   A tick never sees both edges of the same key: a second change stops consumption and
+*   is left for the next tick. A tap therefore moves for at least one tick and two quick
+*   R presses rotate twice.
+*
+*   The ring has one producer (PollGameInput, render thread) and one consumer
+*   (ConsumeGameInput, simulation thread); each side only writes its own index, published
+*   with release/acquire atomics, so it doubles as the queue between the two threads.
+*
+*   Scripted input (the benchmark) replaces the keys altogether: polling does nothing
+*   and every tick gets the flags last set.
+*
+*   Latency mode measures from the poll that saw a press to the tick that changed the
+*   game because of it. raylib polls once per frame, so up to one frame spent in the OS
+*   queue before that poll is not included. The render thread only requests the mode;
+*   the consumer owns the measurement and the stats reach the render thread through the
+*   simulation snapshot.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include <float.h>
+
+#define INPUT_QUEUE_SIZE 256                // Power of two
+#define INPUT_LATENCY_TIMEOUT 0.5           // Seconds before an unanswered press is dropped
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _InputEvent {
+    double time;
+    int key;
+    bool down;
+} InputEvent;
+
+typedef struct _InputBinding {
+    int key;
+    GameInput input;
+} InputBinding;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const InputBinding bindings[] = {
+    { KEY_LEFT, INPUT_LEFT },
+    { KEY_A, INPUT_LEFT },
+    { KEY_RIGHT, INPUT_RIGHT },
+    { KEY_D, INPUT_RIGHT },
+    { KEY_R, INPUT_ROTATE },
+    { KEY_BACKSPACE, INPUT_REWIND },
+};
+
+#define INPUT_BINDINGS (int)(sizeof(bindings) / sizeof(bindings[0]))
+
+static InputEvent events[INPUT_QUEUE_SIZE] = { 0 };
+static unsigned int eventHead = 0;         // Written by the producer only
+static unsigned int eventTail = 0;         // Written by the consumer only
+
+static bool polledDown[INPUT_BINDINGS] = { 0 };     // As last seen by the poll
+static bool tickDown[INPUT_BINDINGS] = { 0 };       // As last consumed by a tick
+
+static int scriptedInput = -1;                      // GameInput flags, -1 while the keys are used
+
+static unsigned int latencyRequest = 0;             // Render thread, bumped by every F4, odd while enabled
+
+// Consumer thread only
+static unsigned int latencyMode = 0;                // Request the stats below belong to
+static double pendingPress = -1.0;                  // Poll time of the oldest unanswered press
+static int latencyCount = 0;
+static double latencySum = 0.0;
+static double latencyMin = 0.0;
+static double latencyMax = 0.0;
+
+static InputLatency shownLatency = { 0 };           // Render thread only
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int FindBinding(int key)
+{
+    for (int b = 0; b < INPUT_BINDINGS; b++) {
+        if (bindings[b].key == key) return b;
+    }
+    return -1;
+}
+
+// Consumer side, picks up a mode change requested by the render thread
+static void ResetInputLatency(unsigned int request)
+{
+    latencyMode = request;
+    latencyCount = 0;
+    latencySum = 0.0;
+    latencyMin = DBL_MAX;
+    latencyMax = 0.0;
+    pendingPress = -1.0;
+}
+
+static void PushEvent(double time, int binding, bool down)
+{
+    // Full only if nobody consumes, the key state is then pushed again by a later poll
+    if (eventHead - __atomic_load_n(&eventTail, __ATOMIC_ACQUIRE) >= INPUT_QUEUE_SIZE) return;
+
+    events[eventHead & (INPUT_QUEUE_SIZE - 1)] = (InputEvent){ time, binding, down };
+    __atomic_store_n(&eventHead, eventHead + 1, __ATOMIC_RELEASE);
+    polledDown[binding] = down;
+}
+
+//----------------------------------------------------------------------------------
+// Input Functions Definition
+//----------------------------------------------------------------------------------
+void PollGameInput(void)
+{
+    double now = GetTime();
+    int key = 0;
+
+    if (__atomic_load_n(&scriptedInput, __ATOMIC_RELAXED) >= 0) return;
+
+    // Queued presses first, in the order they arrived
+    while ((key = GetKeyPressed()) != 0) {
+        int binding = FindBinding(key);
+        if (binding < 0) continue;
+
+        if (polledDown[binding]) PushEvent(now, binding, false);
+        PushEvent(now, binding, true);
+    }
+
+    // raylib has no release queue, releases (and presses missed by the queue) come from the key state
+    for (int b = 0; b < INPUT_BINDINGS; b++) {
+        bool down = IsKeyDown(bindings[b].key);
+        if (down != polledDown[b]) PushEvent(now, b, down);
+    }
+}
+
+void ClearGameInput(void)
+{
+    while (GetKeyPressed() != 0) { }
+    eventTail = eventHead;
+    for (int b = 0; b < INPUT_BINDINGS; b++) {
+        polledDown[b] = IsKeyDown(bindings[b].key);
+        tickDown[b] = polledDown[b];
+    }
+    pendingPress = -1.0;
+}
+
+int ConsumeGameInput(double tickTime)
+{
+    bool changed[INPUT_BINDINGS] = { 0 };
+    bool pressed[INPUT_BINDINGS] = { 0 };
+    unsigned int head = __atomic_load_n(&eventHead, __ATOMIC_ACQUIRE);
+    unsigned int tail = eventTail;
+    int scripted = __atomic_load_n(&scriptedInput, __ATOMIC_RELAXED);
+    unsigned int request = __atomic_load_n(&latencyRequest, __ATOMIC_RELAXED);
+
+    if (request != latencyMode) ResetInputLatency(request);
+    if (scripted >= 0) return scripted;
+
+    while (tail != head) {
+        const InputEvent *event = &events[tail & (INPUT_QUEUE_SIZE - 1)];
+
+        if (event->time > tickTime) break;
+        if (changed[event->key]) break;     // Other edge of a key already changed this tick
+
+        changed[event->key] = true;
+        tickDown[event->key] = event->down;
+        if (event->down) {
+            pressed[event->key] = true;
+            if ((latencyMode & 1) && (pendingPress < 0.0)) pendingPress = event->time;
+        }
+        tail++;
+    }
+    __atomic_store_n(&eventTail, tail, __ATOMIC_RELEASE);
+
+    bool left = false;
+    bool right = false;
+    bool rotate = false;
+    bool rewind = false;
+
+    for (int b = 0; b < INPUT_BINDINGS; b++) {
+        bool active = tickDown[b] || pressed[b];
+        if (bindings[b].input == INPUT_LEFT) left |= active;
+        else if (bindings[b].input == INPUT_RIGHT) right |= active;
+        else if (bindings[b].input == INPUT_ROTATE) rotate |= pressed[b];
+        else if (bindings[b].input == INPUT_REWIND) rewind |= active;
+    }
+
+    // Left wins when both directions are held
+    int input = INPUT_NONE;
+    if (left) input |= INPUT_LEFT;
+    else if (right) input |= INPUT_RIGHT;
+    if (rotate) input |= INPUT_ROTATE;
+    if (rewind) input |= INPUT_REWIND;
+
+    return input;
+}
+
+void SetScriptedGameInput(int input)
+{
+    __atomic_store_n(&scriptedInput, input, __ATOMIC_RELAXED);
+}
+
+void SetInputLatencyMode(bool enabled)
+{
+    if (IsInputLatencyMode() && !enabled && (shownLatency.count > 0)) {
+        TraceLog(LOG_INFO, "INPUT: Press to state change latency over %i presses: min %.2f ms, avg %.2f ms, max %.2f ms",
+                 shownLatency.count, shownLatency.min, shownLatency.avg, shownLatency.max);
+    }
+
+    // The consumer resets its stats on the next tick
+    shownLatency = (InputLatency){ 0 };
+    if (enabled != IsInputLatencyMode()) __atomic_store_n(&latencyRequest, latencyRequest + 1, __ATOMIC_RELAXED);
+}
+
+bool IsInputLatencyMode(void)
+{
+    return (latencyRequest & 1);
+}
+
+void MarkInputResponse(bool stateChanged)
+{
+    if (!(latencyMode & 1) || (pendingPress < 0.0)) return;
+
+    double latency = GetTime() - pendingPress;
+
+    if (stateChanged) {
+        latencyCount++;
+        latencySum += latency;
+        if (latency < latencyMin) latencyMin = latency;
+        if (latency > latencyMax) latencyMax = latency;
+        pendingPress = -1.0;
+    }
+    else if (latency > INPUT_LATENCY_TIMEOUT) pendingPress = -1.0;     // Press had no effect (e.g. rotating mid-air)
+}
+
+InputLatency GetInputLatency(void)
+{
+    if (!(latencyMode & 1) || (latencyCount == 0)) return (InputLatency){ 0 };
+
+    return (InputLatency){ latencyCount, (float)(latencyMin * 1000.0), (float)(latencySum / latencyCount * 1000.0), (float)(latencyMax * 1000.0) };
+}
+
+void UpdateInputLatency(InputLatency latency)
+{
+    // A snapshot from before the last F4 may still carry the old stats
+    if (IsInputLatencyMode()) shownLatency = latency;
+}
+
+void DrawInputLatency(int posX, int posY)
+{
+    if (!IsInputLatencyMode()) return;
+
+    if (shownLatency.count == 0) DrawText("input latency: press a key", posX, posY, 10, LIME);
+    else DrawText(TextFormat("input %.1f / %.1f / %.1f ms", shownLatency.min, shownLatency.avg, shownLatency.max), posX, posY, 10, LIME);
+}
@@ -0,0 +1,172 @@
+/**********************************************************************************************
+*
+*   Lighting Functions Definitions
+*
+*   Mine lighting in a single fragment shader pass. The gameplay world is drawn into a
+*   render texture, a tiny one-channel lightmap (LIGHTMAP_SCALE texels per tile) is
+*   filled on the CPU every tick from the player light and emissive tiles, and the
+*   frame is blitted once through a shader multiplying both. Low oxygen shrinks the
+*   player light and darkens the screen edges.
+*
+*   The lightmap is bilinear filtered, so the per-texel falloff stays smooth on screen.
+*   Lower detail levels fill one texel per tile, or skip the pass and draw unlit.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include "display.h"
+#include <math.h>
+
+#if defined(PLATFORM_DESKTOP)
+    #define GLSL_VERSION            330
+#else   // PLATFORM_RPI, PLATFORM_DRM, PLATFORM_ANDROID, PLATFORM_WEB
+    #define GLSL_VERSION            100
+#endif
+
+#define LIGHTMAP_SCALE 2                // Texels per tile at LIGHTING_FULL
+#define LIGHTMAP_SIZE (ROOM_SIZE * LIGHTMAP_SCALE)
+
+#define AMBIENT_LIGHT 0.12f
+#define PLAYER_LIGHT_RADIUS 4.0f        // In tiles, at full oxygen
+#define EXIT_LIGHT_RADIUS 1.5f
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static RenderTexture2D target = { 0 };
+static Texture2D lightmap = { 0 };
+static Shader shader = { 0 };
+static int lightmapLoc = -1;
+static int darknessLoc = -1;
+
+static unsigned char lightValues[LIGHTMAP_SIZE * LIGHTMAP_SIZE] = { 0 };
+static float darkness = 0.0f;
+static LightingDetail detail = LIGHTING_FULL;
+static int scale = LIGHTMAP_SCALE;      // Texels per tile of the current lightmap
+static int size = LIGHTMAP_SIZE;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Adds a quadratic falloff light around (x, y), both in tiles
+static void AddLight(float *light, float x, float y, float radius, float intensity)
+{
+    int minX = (int)((x - radius) * scale);
+    int maxX = (int)((x + radius) * scale);
+    int minY = (int)((y - radius) * scale);
+    int maxY = (int)((y + radius) * scale);
+
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > size - 1) maxX = size - 1;
+    if (maxY > size - 1) maxY = size - 1;
+
+    for (int i = minY; i <= maxY; i++) {
+        for (int j = minX; j <= maxX; j++) {
+            float dx = (j + 0.5f) / scale - x;
+            float dy = (i + 0.5f) / scale - y;
+            float falloff = 1.0f - sqrtf(dx * dx + dy * dy) / radius;
+            if (falloff > 0.0f) light[i * size + j] += intensity * falloff * falloff;
+        }
+    }
+}
+
+static void LoadLightmap(void)
+{
+    Image image = GenImageColor(size, size, WHITE);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+    lightmap = LoadTextureFromImageTracked(image);
+    UnloadImage(image);
+    SetTextureFilter(lightmap, TEXTURE_FILTER_BILINEAR);
+}
+
+//----------------------------------------------------------------------------------
+// Lighting Functions Definition
+//----------------------------------------------------------------------------------
+void InitLighting(void)
+{
+    target = LoadRenderTextureTracked(ROOM_SIZE * TILE_SIZE, ROOM_SIZE * TILE_SIZE);
+    LoadLightmap();
+
+    shader = LoadShader(0, TextFormat("resources/shaders/glsl%i/lighting.fs", GLSL_VERSION));
+    lightmapLoc = GetShaderLocation(shader, "lightmap");
+    darknessLoc = GetShaderLocation(shader, "darkness");
+}
+
+void UnloadLighting(void)
+{
+    UnloadShader(shader);
+    UnloadTextureTracked(lightmap);
+    UnloadRenderTextureTracked(target);
+    lightmap = (Texture2D){ 0 };
+}
+
+// The new lightmap is filled on the next UpdateLighting()
+void SetLightingDetail(LightingDetail level)
+{
+    int newScale = (level == LIGHTING_COARSE) ? 1 : LIGHTMAP_SCALE;
+
+    detail = level;
+    if (newScale == scale) return;
+
+    scale = newScale;
+    size = ROOM_SIZE * scale;
+    if (lightmap.id > 0) {
+        UnloadTextureTracked(lightmap);
+        LoadLightmap();
+    }
+}
+
+void UpdateLighting(const GameState *state)
+{
+    static float light[LIGHTMAP_SIZE * LIGHTMAP_SIZE];
+    const Player *player = &state->player;
+    Vector2 position = GetPlayerPosition(player);
+    float oxygen = (float)player->oxygen / GetSimulationMaxOxygen();
+
+    if (detail == LIGHTING_OFF) return;
+    if (oxygen < 0.0f) oxygen = 0.0f;
+    if (oxygen > 1.0f) oxygen = 1.0f;
+
+    for (int i = 0; i < size * size; i++) light[i] = AMBIENT_LIGHT;
+
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) {
+            if (state->room.tiles[i][j] == EXIT) AddLight(light, j + 0.5f, i + 0.5f, EXIT_LIGHT_RADIUS, 0.8f);
+        }
+    }
+
+    AddLight(light, (position.x + player->width / 2.0f) / TILE_SIZE, (position.y + player->height / 2.0f) / TILE_SIZE,
+             PLAYER_LIGHT_RADIUS * (0.4f + 0.6f * oxygen), 1.0f);
+
+    for (int i = 0; i < size * size; i++) {
+        float value = (light[i] > 1.0f) ? 1.0f : light[i];
+        lightValues[i] = (unsigned char)(value * 255.0f);
+    }
+    UpdateTexture(lightmap, lightValues);
+
+    darkness = 1.0f - oxygen;
+}
+
+// Everything drawn between begin and end is lit, HUD goes after EndLighting()
+void BeginLighting(void)
+{
+    if (detail == LIGHTING_OFF) return;
+    PushRenderTarget(target);
+    ClearBackground(BLACK);
+}
+
+void EndLighting(void)
+{
+    if (detail == LIGHTING_OFF) return;
+    PopRenderTarget();
+
+    BeginShaderMode(shader);
+        SetShaderValueTexture(shader, lightmapLoc, lightmap);
+        SetShaderValue(shader, darknessLoc, &darkness, SHADER_UNIFORM_FLOAT);
+        DrawTextureRec(target.texture, (Rectangle){ 0.0f, 0.0f, (float)target.texture.width, (float)-target.texture.height }, (Vector2){ 0.0f, 0.0f }, WHITE);
+    EndShaderMode();
+}
@@ -0,0 +1,239 @@
+/**********************************************************************************************
+*
+*   Log Sink Functions Definitions
+*
+*   The ring is a bounded multi producer queue with one sequence number per slot: a
+*   producer claims a position with a compare-and-swap, formats the message in place and
+*   publishes it by storing the next sequence; the writer thread owns the read position
+*   and hands the slot back one lap ahead. A message whose producer has not published it
+*   yet stops the writer until the next round, so the order is kept.
+*
+*   The crash handler writes the published messages left with write(), which is safe in a
+*   signal handler, then lets the default handler run.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "logsink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <signal.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+#define LOGSINK_RING_SIZE 256               // Power of two
+#define LOGSINK_MESSAGE_SIZE 256            // Prefix and newline included, longer messages are cut
+#define LOGSINK_WRITE_INTERVAL 5000000      // Nanoseconds the writer sleeps when the ring is empty
+
+#if !defined(PLATFORM_WEB)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _LogSlot {
+    unsigned int sequence;
+    int length;
+    char text[LOGSINK_MESSAGE_SIZE];
+} LogSlot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static LogSlot ring[LOGSINK_RING_SIZE] = { 0 };
+static unsigned int writePosition = 0;      // Claimed by producers
+static unsigned int readPosition = 0;       // Written by the writer thread only
+
+static int rateLimit = LOGSINK_DEFAULT_RATE;
+static unsigned int rateSecond = 0;
+static unsigned int rateCount = 0;
+static unsigned int dropped = 0;
+
+static pthread_t writer;
+static bool writerRunning = false;
+static bool writerQuit = false;
+
+static const int crashSignals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static const char *GetLevelPrefix(int logLevel)
+{
+    switch (logLevel) {
+        case LOG_TRACE: return "TRACE: ";
+        case LOG_DEBUG: return "DEBUG: ";
+        case LOG_INFO: return "INFO: ";
+        case LOG_WARNING: return "WARNING: ";
+        case LOG_ERROR: return "ERROR: ";
+        case LOG_FATAL: return "FATAL: ";
+        default: return "";
+    }
+}
+
+static unsigned int GetSecond(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned int)now.tv_sec;
+}
+
+// Budget shared by every thread, the count restarts with each new second
+static bool IsRateLimited(void)
+{
+    unsigned int second = GetSecond();
+    unsigned int current = __atomic_load_n(&rateSecond, __ATOMIC_RELAXED);
+
+    if ((second != current) && __atomic_compare_exchange_n(&rateSecond, &current, second, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&rateCount, 0, __ATOMIC_RELAXED);
+    }
+    return (__atomic_fetch_add(&rateCount, 1, __ATOMIC_RELAXED) >= (unsigned int)rateLimit);
+}
+
+static void QueueMessage(int logLevel, const char *text, va_list args)
+{
+    unsigned int position = __atomic_load_n(&writePosition, __ATOMIC_RELAXED);
+    LogSlot *slot = NULL;
+
+    for (;;) {
+        slot = &ring[position & (LOGSINK_RING_SIZE - 1)];
+        int lag = (int)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+
+        if (lag == 0) {
+            if (__atomic_compare_exchange_n(&writePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        }
+        else if (lag < 0) {
+            __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);     // Full, the writer is a lap behind
+            return;
+        }
+        else position = __atomic_load_n(&writePosition, __ATOMIC_RELAXED);
+    }
+
+    int length = snprintf(slot->text, LOGSINK_MESSAGE_SIZE, "%s", GetLevelPrefix(logLevel));
+    length += vsnprintf(slot->text + length, LOGSINK_MESSAGE_SIZE - length, text, args);
+    if (length > LOGSINK_MESSAGE_SIZE - 2) length = LOGSINK_MESSAGE_SIZE - 2;
+    slot->text[length++] = '\n';
+    slot->length = length;
+
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+// Writes every published message in order, returns how many
+static int WriteMessages(bool signalSafe)
+{
+    int written = 0;
+
+    for (;;) {
+        unsigned int position = __atomic_load_n(&readPosition, __ATOMIC_RELAXED);
+        LogSlot *slot = &ring[position & (LOGSINK_RING_SIZE - 1)];
+
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1) break;
+
+        if (signalSafe) {
+            ssize_t result = write(STDOUT_FILENO, slot->text, slot->length);
+            (void)result;
+        }
+        else fwrite(slot->text, 1, slot->length, stdout);
+
+        __atomic_store_n(&slot->sequence, position + LOGSINK_RING_SIZE, __ATOMIC_RELEASE);
+        __atomic_store_n(&readPosition, position + 1, __ATOMIC_RELEASE);
+        written++;
+    }
+
+    return written;
+}
+
+static void WriteDropped(void)
+{
+    unsigned int count = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+    if (count > 0) fprintf(stdout, "WARNING: LOG: %u messages dropped (rate limit or full queue)\n", count);
+}
+
+static void *RunWriter(void *data)
+{
+    struct timespec wait = { 0, LOGSINK_WRITE_INTERVAL };
+
+    while (!__atomic_load_n(&writerQuit, __ATOMIC_ACQUIRE)) {
+        int written = WriteMessages(false);
+
+        WriteDropped();
+        if (written > 0) fflush(stdout);
+        else nanosleep(&wait, NULL);
+    }
+
+    return NULL;
+}
+
+static void WriteOnCrash(int signal)
+{
+    WriteMessages(true);
+
+    // Default handler, so the process still dies with the same signal
+    struct sigaction action = { 0 };
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+    raise(signal);
+}
+
+static void LogSinkCallback(int logLevel, const char *text, va_list args)
+{
+    if ((logLevel <= LOG_INFO) && IsRateLimited()) {
+        __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    QueueMessage(logLevel, text, args);
+
+    // raylib exits on fatal errors, but not when a callback handles them
+    if (logLevel == LOG_FATAL) {
+        CloseLogSink();
+        exit(EXIT_FAILURE);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Log Sink Functions Definition
+//----------------------------------------------------------------------------------
+void InitLogSink(int logLevel, int maxPerSecond)
+{
+    SetTraceLogLevel(logLevel);
+
+#if !defined(PLATFORM_WEB)
+    for (unsigned int i = 0; i < LOGSINK_RING_SIZE; i++) ring[i].sequence = i;
+    writePosition = 0;
+    readPosition = 0;
+    rateLimit = (maxPerSecond > 0) ? maxPerSecond : LOGSINK_DEFAULT_RATE;
+
+    writerQuit = false;
+    writerRunning = (pthread_create(&writer, NULL, RunWriter, NULL) == 0);
+    if (!writerRunning) return;     // raylib keeps writing directly
+
+    struct sigaction action = { 0 };
+    action.sa_handler = WriteOnCrash;
+    action.sa_flags = SA_RESETHAND;
+    for (int i = 0; i < (int)(sizeof(crashSignals) / sizeof(crashSignals[0])); i++) sigaction(crashSignals[i], &action, NULL);
+
+    SetTraceLogCallback(LogSinkCallback);
+#endif
+}
+
+void CloseLogSink(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (!writerRunning) return;
+
+    SetTraceLogCallback(NULL);
+    __atomic_store_n(&writerQuit, true, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+    writerRunning = false;
+
+    WriteMessages(false);
+    WriteDropped();
+    fflush(stdout);
+#endif
+}
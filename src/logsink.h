@@ -0,0 +1,34 @@
+/**********************************************************************************************
+*
+*   Log Sink
+*
+*   Replaces raylib's synchronous TraceLog() output: messages are formatted by the calling
+*   thread into a lock-free multi producer ring and written to stdout by a background
+*   thread, so logging never waits on the console. Messages over the per-second budget
+*   (LOG_INFO and below only) or arriving while the ring is full are dropped and reported
+*   as a count. Fatal errors and crashes (SIGSEGV, SIGABRT...) flush the ring first.
+*
+*   On PLATFORM_WEB raylib's own output is kept.
+*
+**********************************************************************************************/
+
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#define LOGSINK_DEFAULT_RATE 500            // LOG_INFO and below lines per second
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Log Sink Functions Declaration
+//----------------------------------------------------------------------------------
+void InitLogSink(int logLevel, int maxPerSecond);   // Before InitWindow(), messages under logLevel are filtered by raylib
+void CloseLogSink(void);                            // After CloseWindow(), writes what is left
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGSINK_H
@@ -0,0 +1,294 @@
+/**********************************************************************************************
+*
+*   Memory Tracking Functions Definitions
+*
+*   Records live in a fixed table searched linearly, loads and unloads only happen on
+*   screen changes. A resource is keyed by what identifies it to raylib (texture id,
+*   image data, audio buffer) so unloading a copy of the struct still finds it.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "memtrack.h"
+#include "audio.h"
+#include "preload.h"
+#include <string.h>
+
+#define MEMORY_MAX_RECORDS 512
+#define MEMORY_LABEL_SIZE 48
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _MemoryRecord {
+    MemoryCategory category;
+    uintptr_t key;
+    size_t bytes;
+    const char *owner;
+    char label[MEMORY_LABEL_SIZE];
+} MemoryRecord;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *categoryNames[MEMORY_CATEGORY_COUNT] = { "heap", "images", "vram", "audio" };
+
+static MemoryRecord records[MEMORY_MAX_RECORDS] = { 0 };
+static int recordCount = 0;
+static bool recordsFull = false;
+
+static size_t usage[MEMORY_CATEGORY_COUNT] = { 0 };
+static size_t peak[MEMORY_CATEGORY_COUNT] = { 0 };
+static const char *currentOwner = "GLOBAL";
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static size_t TextureBytes(Texture2D texture)
+{
+    size_t bytes = (size_t)GetPixelDataSize(texture.width, texture.height, texture.format);
+
+    // A full mip chain adds about a third
+    if (texture.mipmaps > 1) bytes += bytes / 3;
+    return bytes;
+}
+
+static size_t StreamBytes(AudioStream stream, unsigned int frames)
+{
+    return (size_t)frames * stream.channels * (stream.sampleSize / 8);
+}
+
+// Resources made from an image keep the image's label
+static const char *GetImageLabel(Image image, const char *label)
+{
+    for (int i = 0; i < recordCount; i++) {
+        if ((records[i].category == MEMORY_IMAGE) && (records[i].key == (uintptr_t)image.data)) label = records[i].label;
+    }
+    return label;
+}
+
+static const char *FormatBytes(size_t bytes)
+{
+    if (bytes >= 1024 * 1024) return TextFormat("%.2f MB", bytes / (1024.0 * 1024.0));
+    return TextFormat("%.1f KB", bytes / 1024.0);
+}
+
+//----------------------------------------------------------------------------------
+// Memory Tracking Functions Definition
+//----------------------------------------------------------------------------------
+void SetMemoryOwner(const char *owner)
+{
+    currentOwner = owner;
+}
+
+void TrackMemory(MemoryCategory category, uintptr_t key, size_t bytes, const char *label)
+{
+    if (key == 0) return;       // Failed load, nothing to track
+
+    if (recordCount >= MEMORY_MAX_RECORDS) {
+        if (!recordsFull) TraceLog(LOG_WARNING, "MEMORY: Record table full, %s not tracked", label);
+        recordsFull = true;
+        return;
+    }
+
+    MemoryRecord *record = &records[recordCount++];
+    record->category = category;
+    record->key = key;
+    record->bytes = bytes;
+    record->owner = currentOwner;
+    strncpy(record->label, (label != NULL) ? label : "", MEMORY_LABEL_SIZE - 1);
+    record->label[MEMORY_LABEL_SIZE - 1] = '\0';
+
+    usage[category] += bytes;
+    if (usage[category] > peak[category]) peak[category] = usage[category];
+}
+
+void UntrackMemory(MemoryCategory category, uintptr_t key)
+{
+    for (int i = 0; i < recordCount; i++) {
+        if ((records[i].category == category) && (records[i].key == key)) {
+            usage[category] -= records[i].bytes;
+            records[i] = records[--recordCount];
+            return;
+        }
+    }
+}
+
+size_t GetMemoryUsage(MemoryCategory category)
+{
+    return usage[category];
+}
+
+size_t GetMemoryPeak(MemoryCategory category)
+{
+    return peak[category];
+}
+
+void DrawMemoryOverlay(int posX, int posY)
+{
+    size_t total = 0;
+
+    for (int c = 0; c < MEMORY_CATEGORY_COUNT; c++) {
+        DrawText(TextFormat("%-6s %s", categoryNames[c], FormatBytes(usage[c])), posX, posY + 12 * c, 10, LIME);
+        total += usage[c];
+    }
+    DrawText(TextFormat("total  %s, %i live", FormatBytes(total), recordCount), posX, posY + 12 * MEMORY_CATEGORY_COUNT, 10, LIME);
+}
+
+int TraceMemoryLeaks(void)
+{
+    for (int i = 0; i < recordCount; i++) {
+        TraceLog(LOG_WARNING, "MEMORY: Leak [%s] %s %s (%s)", records[i].owner, categoryNames[records[i].category],
+                 records[i].label, FormatBytes(records[i].bytes));
+    }
+
+    for (int c = 0; c < MEMORY_CATEGORY_COUNT; c++) {
+        TraceLog(LOG_INFO, "MEMORY: %-6s peak %s, leaked %s", categoryNames[c], FormatBytes(peak[c]), FormatBytes(usage[c]));
+    }
+    if (recordCount == 0) TraceLog(LOG_INFO, "MEMORY: No leaks");
+
+    return recordCount;
+}
+
+//----------------------------------------------------------------------------------
+// Tracked Resource Functions Definition
+//----------------------------------------------------------------------------------
+void *MemAllocTracked(unsigned int size, const char *label)
+{
+    void *ptr = MemAlloc(size);
+    TrackMemory(MEMORY_HEAP, (uintptr_t)ptr, size, label);
+    return ptr;
+}
+
+void MemFreeTracked(void *ptr)
+{
+    UntrackMemory(MEMORY_HEAP, (uintptr_t)ptr);
+    MemFree(ptr);
+}
+
+Image LoadImageTracked(const char *fileName)
+{
+    LockDecode();
+    Image image = LoadImage(fileName);
+    UnlockDecode();
+
+    TrackMemory(MEMORY_IMAGE, (uintptr_t)image.data, (size_t)GetPixelDataSize(image.width, image.height, image.format), GetFileName(fileName));
+    return image;
+}
+
+void ImageResizeTracked(Image *image, int newWidth, int newHeight)
+{
+    char label[MEMORY_LABEL_SIZE] = "image";
+
+    // Resizing reallocates, move the record over to the new data
+    for (int i = 0; i < recordCount; i++) {
+        if ((records[i].category == MEMORY_IMAGE) && (records[i].key == (uintptr_t)image->data)) strcpy(label, records[i].label);
+    }
+    UntrackMemory(MEMORY_IMAGE, (uintptr_t)image->data);
+    ImageResize(image, newWidth, newHeight);
+    TrackMemory(MEMORY_IMAGE, (uintptr_t)image->data, (size_t)GetPixelDataSize(image->width, image->height, image->format), label);
+}
+
+void UnloadImageTracked(Image image)
+{
+    UntrackMemory(MEMORY_IMAGE, (uintptr_t)image.data);
+    UnloadImage(image);
+}
+
+Texture2D LoadTextureFromImageTracked(Image image)
+{
+    Texture2D texture = LoadTextureFromImage(image);
+    TrackMemory(MEMORY_TEXTURE, texture.id, TextureBytes(texture), GetImageLabel(image, "texture"));
+    return texture;
+}
+
+void UnloadTextureTracked(Texture2D texture)
+{
+    UntrackMemory(MEMORY_TEXTURE, texture.id);
+    UnloadTexture(texture);
+}
+
+RenderTexture2D LoadRenderTextureTracked(int width, int height)
+{
+    RenderTexture2D target = LoadRenderTexture(width, height);
+
+    // Color attachment plus a 32-bit depth buffer
+    TrackMemory(MEMORY_TEXTURE, target.texture.id, TextureBytes(target.texture) + (size_t)width * height * 4, "render texture");
+    return target;
+}
+
+void UnloadRenderTextureTracked(RenderTexture2D target)
+{
+    UntrackMemory(MEMORY_TEXTURE, target.texture.id);
+    UnloadRenderTexture(target);
+}
+
+Font LoadFontTracked(const char *fileName)
+{
+    LockDecode();
+    Font font = LoadFont(fileName);
+    UnlockDecode();
+
+    const char *label = GetFileName(fileName);
+
+    TrackMemory(MEMORY_TEXTURE, font.texture.id, TextureBytes(font.texture), label);
+    TrackMemory(MEMORY_HEAP, (uintptr_t)font.glyphs, (size_t)font.glyphCount * (sizeof(GlyphInfo) + sizeof(Rectangle)), label);
+    return font;
+}
+
+Font LoadFontFromImageTracked(Image image, Color key, int firstChar)
+{
+    Font font = LoadFontFromImage(image, key, firstChar);
+    const char *label = GetImageLabel(image, "font");
+
+    TrackMemory(MEMORY_TEXTURE, font.texture.id, TextureBytes(font.texture), label);
+    TrackMemory(MEMORY_HEAP, (uintptr_t)font.glyphs, (size_t)font.glyphCount * (sizeof(GlyphInfo) + sizeof(Rectangle)), label);
+    return font;
+}
+
+void UnloadFontTracked(Font font)
+{
+    UntrackMemory(MEMORY_TEXTURE, font.texture.id);
+    UntrackMemory(MEMORY_HEAP, (uintptr_t)font.glyphs);
+    UnloadFont(font);
+}
+
+Sound LoadSoundTracked(const char *fileName)
+{
+    LockDecode();
+    Sound sound = LoadSound(fileName);
+    UnlockDecode();
+
+    TrackMemory(MEMORY_AUDIO, (uintptr_t)sound.stream.buffer, StreamBytes(sound.stream, sound.frameCount), GetFileName(fileName));
+    return sound;
+}
+
+Sound LoadSoundFromWaveTracked(Wave wave, const char *fileName)
+{
+    Sound sound = LoadSoundFromWave(wave);
+    TrackMemory(MEMORY_AUDIO, (uintptr_t)sound.stream.buffer, StreamBytes(sound.stream, sound.frameCount), GetFileName(fileName));
+    return sound;
+}
+
+void UnloadSoundTracked(Sound sound)
+{
+    UntrackMemory(MEMORY_AUDIO, (uintptr_t)sound.stream.buffer);
+    UnloadSound(sound);
+}
+
+Music LoadMusicStreamTracked(const char *fileName)
+{
+    LockDecode();
+    Music music = LoadMusicStream(fileName);
+    UnlockDecode();
+
+    // Two sub-buffers of the size set by the audio thread
+    TrackMemory(MEMORY_AUDIO, (uintptr_t)music.stream.buffer, 2 * StreamBytes(music.stream, GetAudioBufferFrames()), GetFileName(fileName));
+    return music;
+}
+
+void UnloadMusicStreamTracked(Music music)
+{
+    UntrackMemory(MEMORY_AUDIO, (uintptr_t)music.stream.buffer);
+    UnloadMusicStream(music);
+}
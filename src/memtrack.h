@@ -0,0 +1,69 @@
+/**********************************************************************************************
+*
+*   Memory Tracking
+*
+*   Drop-in wrappers around the raylib load/unload calls that keep a record of every live
+*   resource: category, estimated bytes, file name and the screen that loaded it. Totals
+*   are shown on the debug overlay (F3) and whatever is still alive at shutdown is
+*   reported as a leak before CloseWindow().
+*
+*   Sizes are estimates: textures count their pixel data (plus mips and depth for render
+*   textures) as VRAM, sounds their decoded PCM, music only its stream buffers.
+*
+**********************************************************************************************/
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum _MemoryCategory {
+    MEMORY_HEAP,
+    MEMORY_IMAGE,               // Decoded images in RAM
+    MEMORY_TEXTURE,             // VRAM estimate
+    MEMORY_AUDIO,               // PCM and stream buffers
+    MEMORY_CATEGORY_COUNT
+} MemoryCategory;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Memory Tracking Functions Declaration
+//----------------------------------------------------------------------------------
+void SetMemoryOwner(const char *owner);                 // Tag for following loads, string must stay valid
+void TrackMemory(MemoryCategory category, uintptr_t key, size_t bytes, const char *label);
+void UntrackMemory(MemoryCategory category, uintptr_t key);
+size_t GetMemoryUsage(MemoryCategory category);
+size_t GetMemoryPeak(MemoryCategory category);
+void DrawMemoryOverlay(int posX, int posY);
+int TraceMemoryLeaks(void);                             // Logs live records, returns how many
+
+//----------------------------------------------------------------------------------
+// Tracked Resource Functions Declaration
+//----------------------------------------------------------------------------------
+void *MemAllocTracked(unsigned int size, const char *label);
+void MemFreeTracked(void *ptr);
+Image LoadImageTracked(const char *fileName);
+void ImageResizeTracked(Image *image, int newWidth, int newHeight);
+void UnloadImageTracked(Image image);
+Texture2D LoadTextureFromImageTracked(Image image);
+void UnloadTextureTracked(Texture2D texture);
+RenderTexture2D LoadRenderTextureTracked(int width, int height);
+void UnloadRenderTextureTracked(RenderTexture2D target);
+Font LoadFontTracked(const char *fileName);
+Font LoadFontFromImageTracked(Image image, Color key, int firstChar);
+void UnloadFontTracked(Font font);
+Sound LoadSoundTracked(const char *fileName);
+Sound LoadSoundFromWaveTracked(Wave wave, const char *fileName);     // The wave is still the caller's
+void UnloadSoundTracked(Sound sound);
+Music LoadMusicStreamTracked(const char *fileName);
+void UnloadMusicStreamTracked(Music music);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMTRACK_H
@@ -0,0 +1,206 @@
+/**********************************************************************************************
+*
+*   Frame Pacing Functions Definitions
+*
+*   Low latency mode keeps a moving average of the frame work (begin of update to the
+*   swap) and sleeps after the swap until that much time, plus a safety margin, is left
+*   before the next vertical blank. raylib already polled input inside EndDrawing(), so
+*   after the sleep the gameplay events queued so far are saved and the OS is polled
+*   again. Key edges of that first poll only survive through the gameplay input queue,
+*   IsKeyPressed() sees the second one.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "pacing.h"
+#include "gameplay.h"
+#include <stdlib.h>
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+#endif
+
+#define PACING_HISTORY 512                  // Present intervals kept for the percentiles
+#define PACING_MISS_FACTOR 1.5              // Interval over expected * factor counts as a missed deadline
+#define PACING_SAFETY_MARGIN 0.0015         // Seconds left between the wake up and the vertical blank
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *modeNames[PACING_MODE_COUNT] = { "vsync", "cap", "uncapped", "low latency" };
+
+static PacingMode pacingMode = PACING_VSYNC;
+static int pacingCap = 60;
+static double expectedInterval = 0.0;       // 0 when there is no deadline (uncapped)
+
+static double lastPresent = 0.0;
+static double frameStart = 0.0;
+static double workAverage = 0.0;           // Update and draw, without the swap
+static float lastWork = 0.0f;
+static float lastInterval = 0.0f;
+
+#if defined(PLATFORM_WEB)
+static bool timingPending = false;          // Loop timing can only be set once the main loop runs
+#endif
+
+static float intervals[PACING_HISTORY] = { 0 };
+static int intervalCount = 0;               // Total since reset, history wraps
+static int missedFrames = 0;
+static double intervalSum = 0.0;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static double GetRefreshInterval(void)
+{
+    int rate = GetMonitorRefreshRate(GetCurrentMonitor());
+    return 1.0 / ((rate > 0) ? rate : 60);
+}
+
+static int CompareFloat(const void *a, const void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// Percentile of the kept history, in seconds
+static float GetIntervalPercentile(float percentile)
+{
+    static float sorted[PACING_HISTORY];
+    int count = (intervalCount < PACING_HISTORY) ? intervalCount : PACING_HISTORY;
+
+    if (count == 0) return 0.0f;
+    for (int i = 0; i < count; i++) sorted[i] = intervals[i];
+    qsort(sorted, count, sizeof(float), CompareFloat);
+    return sorted[(int)(percentile * (count - 1))];
+}
+
+//----------------------------------------------------------------------------------
+// Frame Pacing Functions Definition
+//----------------------------------------------------------------------------------
+void SetFramePacing(PacingMode mode, int fpsCap)
+{
+    if (intervalCount > 0) TraceFramePacingStats();
+
+    pacingMode = mode;
+    pacingCap = (fpsCap > 0) ? fpsCap : 60;
+
+#if defined(PLATFORM_WEB)
+    timingPending = true;
+#else
+    if ((mode == PACING_VSYNC) || (mode == PACING_LOW_LATENCY)) SetWindowState(FLAG_VSYNC_HINT);
+    else ClearWindowState(FLAG_VSYNC_HINT);
+    SetTargetFPS((mode == PACING_CAP) ? pacingCap : 0);
+#endif
+
+    switch (mode) {
+        case PACING_CAP: expectedInterval = 1.0 / pacingCap; break;
+        case PACING_UNCAPPED: expectedInterval = 0.0; break;
+        default: expectedInterval = GetRefreshInterval(); break;
+    }
+
+    TraceLog(LOG_INFO, "PACING: Mode %s", TextFormat((mode == PACING_CAP) ? "%s %i fps" : "%s", modeNames[mode], pacingCap));
+    ResetFramePacingStats();
+}
+
+PacingMode GetFramePacingMode(void)
+{
+    return pacingMode;
+}
+
+int GetFramePacingCap(void)
+{
+    return pacingCap;
+}
+
+double GetFramePacingBudget(void)
+{
+    return expectedInterval;
+}
+
+float GetFrameWorkTime(void)
+{
+    return lastWork;
+}
+
+float GetFramePresentInterval(void)
+{
+    return lastInterval;
+}
+
+const char *GetFramePacingName(PacingMode mode)
+{
+    return modeNames[mode];
+}
+
+void BeginFramePacing(void)
+{
+#if defined(PLATFORM_WEB)
+    if (timingPending) {
+        if (pacingMode == PACING_CAP) emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, 1000 / pacingCap);
+        else if (pacingMode == PACING_UNCAPPED) emscripten_set_main_loop_timing(EM_TIMING_SETIMMEDIATE, 0);
+        else emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+        timingPending = false;
+    }
+#else
+    if ((pacingMode == PACING_LOW_LATENCY) && (lastPresent > 0.0)) {
+        double wake = lastPresent + expectedInterval - workAverage * 1.25 - PACING_SAFETY_MARGIN;
+        double now = GetTime();
+
+        if (wake > now) {
+            WaitTime(wake - now);
+            PollGameInput();
+            PollInputEvents();
+        }
+    }
+#endif
+    frameStart = GetTime();
+}
+
+void SubmitFramePacing(void)
+{
+    lastWork = (float)(GetTime() - frameStart);
+    workAverage += (lastWork - workAverage) * 0.1;
+}
+
+void EndFramePacing(void)
+{
+    double now = GetTime();
+
+    if (lastPresent > 0.0) {
+        double interval = now - lastPresent;
+
+        lastInterval = (float)interval;
+        intervals[intervalCount % PACING_HISTORY] = (float)interval;
+        intervalCount++;
+        intervalSum += interval;
+        if ((expectedInterval > 0.0) && (interval > expectedInterval * PACING_MISS_FACTOR)) missedFrames++;
+    }
+    lastPresent = now;
+}
+
+void ResetFramePacingStats(void)
+{
+    intervalCount = 0;
+    intervalSum = 0.0;
+    missedFrames = 0;
+    workAverage = 0.0;
+    lastPresent = 0.0;
+}
+
+void TraceFramePacingStats(void)
+{
+    if (intervalCount == 0) return;
+
+    TraceLog(LOG_INFO, "PACING: %s, %i frames, avg %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms, %i missed", modeNames[pacingMode],
+             intervalCount, intervalSum / intervalCount * 1000.0, GetIntervalPercentile(0.5f) * 1000.0f,
+             GetIntervalPercentile(0.99f) * 1000.0f, GetIntervalPercentile(1.0f) * 1000.0f, missedFrames);
+}
+
+void DrawFramePacingStats(int posX, int posY)
+{
+    DrawText(TextFormat("%s  p50 %.1f  p99 %.1f ms", modeNames[pacingMode], GetIntervalPercentile(0.5f) * 1000.0f,
+             GetIntervalPercentile(0.99f) * 1000.0f), posX, posY, 10, LIME);
+    DrawText(TextFormat("missed %i of %i", missedFrames, intervalCount), posX, posY + 12, 10, LIME);
+}
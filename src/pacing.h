@@ -0,0 +1,57 @@
+/**********************************************************************************************
+*
+*   Frame Pacing
+*
+*   Selects how frames are paced and measures the result. Every frame the time right
+*   after EndDrawing() (buffer swap) is taken as the present time; the interval between
+*   presents and the frames that missed their deadline (1.5x the expected interval) are
+*   kept for the debug overlay and logged when the mode changes.
+*
+*       PACING_VSYNC        Swap waits for the vertical blank
+*       PACING_CAP          No vsync, raylib sleeps to a fixed frame rate
+*       PACING_UNCAPPED     No vsync, no sleep
+*       PACING_LOW_LATENCY  Vsync, plus a sleep after the swap so input is polled and the
+*                           frame is built just before the next vertical blank
+*
+*   On PLATFORM_WEB the browser drives the loop: vsync and low latency both run on
+*   requestAnimationFrame, the cap on a timeout.
+*
+**********************************************************************************************/
+
+#ifndef PACING_H
+#define PACING_H
+
+typedef enum _PacingMode {
+    PACING_VSYNC,
+    PACING_CAP,
+    PACING_UNCAPPED,
+    PACING_LOW_LATENCY,
+    PACING_MODE_COUNT
+} PacingMode;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Frame Pacing Functions Declaration
+//----------------------------------------------------------------------------------
+void SetFramePacing(PacingMode mode, int fpsCap);       // After InitWindow(), fpsCap only used by PACING_CAP
+PacingMode GetFramePacingMode(void);
+int GetFramePacingCap(void);
+double GetFramePacingBudget(void);                      // Expected present interval, 0 when uncapped
+float GetFrameWorkTime(void);                           // Last frame, begin of update to the swap
+float GetFramePresentInterval(void);                    // Last frame, present to present
+const char *GetFramePacingName(PacingMode mode);
+void BeginFramePacing(void);                            // Start of every frame, before the update
+void SubmitFramePacing(void);                           // Right before EndDrawing(), ends the measured work
+void EndFramePacing(void);                              // Right after EndDrawing()
+void ResetFramePacingStats(void);
+void TraceFramePacingStats(void);
+void DrawFramePacingStats(int posX, int posY);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACING_H
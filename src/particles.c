@@ -0,0 +1,219 @@
+/**********************************************************************************************
+*
+*   Particle Functions Definitions
+*
+*   Dust, debris and oxygen effects from one fixed-capacity pool stored as separate
+*   arrays per field. Live particles are always packed at the front: a dead particle is
+*   replaced by the last live one, so the integration loop runs over plain contiguous
+*   arrays and the compiler can vectorize it. Nothing is allocated after startup.
+*
+*   All live particles are drawn as untextured quads in one rlgl batch (split only when
+*   the batch buffer is full), no per-particle draw call.
+*
+*   When the pool gets crowded new emissions are scaled down instead of failing, and
+*   SetParticleBudget() lowers the live particle limit for slow machines.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "gameplay.h"
+#include <math.h>
+
+#define PARTICLE_BATCH 512              // Quads per batch check, below the smallest rlgl batch size
+#define OXYGEN_BUBBLES 20.0f            // Bubbles per second at zero oxygen
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _ParticleEmitter {
+    int count;                  // Particles per emission, before budget scaling
+    float angle;                // Degrees, 0 is right, -90 is up
+    float spread;               // Degrees around angle
+    float minSpeed;             // Pixels per second
+    float maxSpeed;
+    float gravity;              // Pixels per second squared
+    float minLife;              // Seconds
+    float maxLife;
+    float size;                 // Pixels
+    Color color;
+} ParticleEmitter;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const ParticleEmitter emitters[] = {
+    [PARTICLES_DUST] = { 24, -90.0f, 160.0f, 20.0f, 70.0f, 120.0f, 0.3f, 0.7f, 2.0f, (Color){ 170, 140, 110, 200 } },
+    [PARTICLES_DEBRIS] = { 64, 90.0f, 30.0f, 10.0f, 60.0f, 400.0f, 0.6f, 1.2f, 3.0f, (Color){ 110, 95, 80, 255 } },
+    [PARTICLES_DEATH] = { 96, 0.0f, 360.0f, 60.0f, 220.0f, 300.0f, 0.4f, 1.0f, 3.0f, (Color){ 200, 40, 30, 255 } },
+    [PARTICLES_OXYGEN] = { 1, -90.0f, 40.0f, 15.0f, 30.0f, -20.0f, 0.8f, 1.4f, 2.0f, (Color){ 150, 200, 255, 180 } },
+};
+
+static float positionX[MAX_PARTICLES] = { 0 };
+static float positionY[MAX_PARTICLES] = { 0 };
+static float velocityX[MAX_PARTICLES] = { 0 };
+static float velocityY[MAX_PARTICLES] = { 0 };
+static float gravity[MAX_PARTICLES] = { 0 };
+static float life[MAX_PARTICLES] = { 0 };           // Seconds left
+static float lifeScale[MAX_PARTICLES] = { 0 };      // 1/initial life, for the fade out
+static float size[MAX_PARTICLES] = { 0 };
+static Color color[MAX_PARTICLES] = { 0 };
+
+static int particleCount = 0;
+static int particleBudget = MAX_PARTICLES;
+static unsigned int particleSeed = 0x9e3779b9u;
+static float bubbleTime = 0.0f;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Visual only, no need for the simulation's deterministic random
+static float RandomRange(float min, float max)
+{
+    particleSeed ^= particleSeed << 13;
+    particleSeed ^= particleSeed >> 17;
+    particleSeed ^= particleSeed << 5;
+    return min + (max - min) * (float)(particleSeed >> 8) / (float)(1 << 24);
+}
+
+// Above half the budget each emission shrinks linearly, down to nothing when full
+static int ScaleEmission(int count)
+{
+    int space = particleBudget - particleCount;
+    int half = particleBudget / 2;
+
+    if (space <= 0) return 0;
+    if (space < half) count = (int)((long long)count * space / half);
+    if (count > space) count = space;
+    return count;
+}
+
+static void RemoveParticle(int i)
+{
+    int last = --particleCount;
+
+    positionX[i] = positionX[last];
+    positionY[i] = positionY[last];
+    velocityX[i] = velocityX[last];
+    velocityY[i] = velocityY[last];
+    gravity[i] = gravity[last];
+    life[i] = life[last];
+    lifeScale[i] = lifeScale[last];
+    size[i] = size[last];
+    color[i] = color[last];
+}
+
+//----------------------------------------------------------------------------------
+// Particle Functions Definition
+//----------------------------------------------------------------------------------
+void ClearParticles(void)
+{
+    particleCount = 0;
+    bubbleTime = 0.0f;
+}
+
+void SetParticleBudget(int budget)
+{
+    if (budget < 0) budget = 0;
+    if (budget > MAX_PARTICLES) budget = MAX_PARTICLES;
+    particleBudget = budget;
+}
+
+int GetParticleCount(void)
+{
+    return particleCount;
+}
+
+int EmitParticles(ParticleEffect effect, Rectangle area, int count)
+{
+    const ParticleEmitter *emitter = &emitters[effect];
+
+    if (count <= 0) count = emitter->count;
+    count = ScaleEmission(count);
+
+    for (int k = 0; k < count; k++) {
+        int i = particleCount++;
+        float angle = (emitter->angle + RandomRange(-0.5f, 0.5f) * emitter->spread) * DEG2RAD;
+        float speed = RandomRange(emitter->minSpeed, emitter->maxSpeed);
+        float seconds = RandomRange(emitter->minLife, emitter->maxLife);
+
+        positionX[i] = RandomRange(area.x, area.x + area.width);
+        positionY[i] = RandomRange(area.y, area.y + area.height);
+        velocityX[i] = cosf(angle) * speed;
+        velocityY[i] = sinf(angle) * speed;
+        gravity[i] = emitter->gravity;
+        life[i] = seconds;
+        lifeScale[i] = 1.0f / seconds;
+        size[i] = emitter->size * RandomRange(0.75f, 1.25f);
+        color[i] = emitter->color;
+    }
+
+    return count;
+}
+
+void EmitGameParticles(const GameState *state, int events, float dt)
+{
+    const Player *player = &state->player;
+    Vector2 position = GetPlayerPosition(player);
+    Rectangle body = { position.x, position.y, (float)player->width, (float)player->height };
+
+    if (events & EVENT_GROUNDED) EmitParticles(PARTICLES_DUST, (Rectangle){ body.x, body.y + body.height - 2.0f, body.width, 2.0f }, 0);
+    if (events & EVENT_ROTATED) EmitParticles(PARTICLES_DEBRIS, (Rectangle){ 0.0f, 0.0f, ROOM_SIZE * TILE_SIZE, TILE_SIZE }, 0);
+
+    // Bubbles start at the simulation's low oxygen warning and get denser towards zero
+    float oxygen = (float)player->oxygen / GetSimulationMaxOxygen();
+    float low = (float)GetSimulationOxygenWarning() / GetSimulationMaxOxygen();
+    if (oxygen < low) {
+        bubbleTime += dt * OXYGEN_BUBBLES * (1.0f - oxygen / low);
+        int bubbles = (int)bubbleTime;
+        bubbleTime -= bubbles;
+        if (bubbles > 0) EmitParticles(PARTICLES_OXYGEN, (Rectangle){ body.x + body.width / 4, body.y, body.width / 2, body.height / 4 }, bubbles);
+    }
+}
+
+void UpdateParticles(float dt)
+{
+    int count = particleCount;
+
+    // Independent per-element updates on separate arrays, vectorizes
+    for (int i = 0; i < count; i++) {
+        velocityY[i] += gravity[i] * dt;
+        positionX[i] += velocityX[i] * dt;
+        positionY[i] += velocityY[i] * dt;
+        life[i] -= dt;
+    }
+
+    for (int i = 0; i < particleCount; ) {
+        if (life[i] <= 0.0f) RemoveParticle(i);
+        else i++;
+    }
+}
+
+void DrawParticles(void)
+{
+    if (particleCount == 0) return;
+
+    rlSetTexture(rlGetTextureIdDefault());
+    for (int first = 0; first < particleCount; first += PARTICLE_BATCH) {
+        int last = first + PARTICLE_BATCH;
+        if (last > particleCount) last = particleCount;
+
+        rlCheckRenderBatchLimit(4 * (last - first));
+        rlBegin(RL_QUADS);
+            for (int i = first; i < last; i++) {
+                float x = positionX[i];
+                float y = positionY[i];
+                float s = size[i];
+                float fade = life[i] * lifeScale[i];
+
+                rlColor4ub(color[i].r, color[i].g, color[i].b, (unsigned char)(color[i].a * fade));
+                rlVertex2f(x, y);
+                rlVertex2f(x, y + s);
+                rlVertex2f(x + s, y + s);
+                rlVertex2f(x + s, y);
+            }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
@@ -0,0 +1,374 @@
+/**********************************************************************************************
+*
+*   Automated Playtest Harness
+*
+*   Runs many independent headless game instances on every core, each one driven by an
+*   agent issuing the same left/right/rotate inputs the gameplay screen reads, and prints
+*   a per-room balance report: completion rate, time to exit and death causes.
+*
+*   Build: make playtest (only raylib headers are needed, no window or audio device)
+*
+*   Usage: ./playtest [options]
+*       --agent random|greedy|script    Agent driving every instance (default: greedy)
+*       --script <file>                 Input script for the script agent, see ParseScript()
+*       --attempts <n>                  Attempts per room (default: 1000)
+*       --threads <n>                   Worker threads (default: online cores)
+*       --max-ticks <n>                 Ticks before an attempt times out (default: 3600)
+*       --oxygen <max>                  Oxygen on room entry (default: MAX_OXYGEN)
+*       --drain <rate>                  Oxygen lost per second (default: OXYGEN_DRAIN)
+*       --seed <n>                      Base seed, attempts are reproducible per seed
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define TICK_RATE SIM_TICK_RATE
+#define MAX_THREADS 256
+#define MAX_SCRIPT_STEPS 1024
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum _AgentType {
+    AGENT_RANDOM = 0,
+    AGENT_GREEDY,
+    AGENT_SCRIPT
+} AgentType;
+
+typedef struct _ScriptStep {
+    int input;
+    int ticks;
+} ScriptStep;
+
+typedef struct _Agent {
+    AgentType type;
+    unsigned int seed;
+    int input;                  // Held input (random agent)
+    int holdTicks;
+    int step;                   // Current script step and ticks left in it
+    int stepTicks;
+    int cooldown;               // Ticks before the greedy agent may rotate again
+    int stuckTicks;
+    int lastX;                  // Fixed point
+} Agent;
+
+typedef struct _RoomStats {
+    long attempts;
+    long exits;
+    long hazardDeaths;
+    long oxygenDeaths;
+    long timeouts;
+    long exitTicks;
+    int minExitTicks;
+    int maxExitTicks;
+} RoomStats;
+
+typedef struct _Worker {
+    pthread_t thread;
+    int index;
+    long ticks;
+    double seconds;
+    RoomStats rooms[NUM_ROOMS];
+} Worker;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static AgentType agentType = AGENT_GREEDY;
+static int attemptsPerRoom = 1000;
+static int threadCount = 0;
+static int maxTicks = 60 * TICK_RATE;
+static unsigned int baseSeed = 1;
+
+static ScriptStep script[MAX_SCRIPT_STEPS] = { 0 };
+static int scriptLength = 0;
+
+static Worker workers[MAX_THREADS] = { 0 };
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned int NextRandom(unsigned int *seed)
+{
+    unsigned int x = *seed;
+    if (x == 0) x = 0x9e3779b9;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+static double GetSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Script format: whitespace separated steps, a letter with an optional tick count.
+// L = left, R = right, T = rotate (single tick), W = wait. Example: "R90 T W30 L45"
+static bool ParseScript(const char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return false;
+
+    char token[32];
+    while ((scriptLength < MAX_SCRIPT_STEPS) && (fscanf(file, "%31s", token) == 1)) {
+        ScriptStep step = { INPUT_NONE, 1 };
+        switch (token[0]) {
+            case 'L': step.input = INPUT_LEFT; break;
+            case 'R': step.input = INPUT_RIGHT; break;
+            case 'T': step.input = INPUT_ROTATE; break;
+            case 'W': break;
+            default: fclose(file); return false;
+        }
+        if (token[1] != '\0') step.ticks = atoi(token + 1);
+        if (step.ticks < 1) step.ticks = 1;
+        script[scriptLength++] = step;
+    }
+    fclose(file);
+    return (scriptLength > 0);
+}
+
+static int FindExit(const GameState *state, int *x, int *y)
+{
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) {
+            if (state->room.tiles[i][j] == EXIT) {
+                *x = j;
+                *y = i;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Walk toward the exit while it is level with or below the player, rotate otherwise
+// or when walking doesn't get anywhere. Hazards right ahead also trigger a rotation.
+static int GetGreedyInput(Agent *agent, const GameState *state)
+{
+    const Player *player = &state->player;
+    int exitX = 0, exitY = 0;
+    int playerX = (player->position.x + FIXED(player->width / 2)) / FIXED(TILE_SIZE);
+    int playerY = (player->position.y + FIXED(player->height / 2)) / FIXED(TILE_SIZE);
+
+    if (agent->cooldown > 0) agent->cooldown--;
+    if (!FindExit(state, &exitX, &exitY)) return INPUT_NONE;
+
+    int input = INPUT_NONE;
+    if (exitX < playerX) input = INPUT_LEFT;
+    else if (exitX > playerX) input = INPUT_RIGHT;
+
+    if ((player->position.x == agent->lastX) && (input != INPUT_NONE)) agent->stuckTicks++;
+    else agent->stuckTicks = 0;
+    agent->lastX = player->position.x;
+
+    bool wantRotate = (exitY < playerY) || (agent->stuckTicks > 20);
+    if (input != INPUT_NONE) {
+        int aheadX = playerX + ((input == INPUT_LEFT) ? -1 : 1);
+        int belowY = playerY + 1;
+        if ((aheadX >= 0) && (aheadX < ROOM_SIZE) && (belowY < ROOM_SIZE) && IsDeath(state->room.tiles[belowY][aheadX])) wantRotate = true;
+    }
+
+    if (wantRotate && (agent->cooldown == 0) && (player->state != FALL)) {
+        agent->cooldown = TICK_RATE / 2;
+        agent->stuckTicks = 0;
+        return INPUT_ROTATE;
+    }
+    return input;
+}
+
+static int GetAgentInput(Agent *agent, const GameState *state)
+{
+    int input = INPUT_NONE;
+
+    switch (agent->type) {
+        case AGENT_RANDOM:
+        {
+            if (agent->holdTicks <= 0) {
+                static const int choices[3] = { INPUT_NONE, INPUT_LEFT, INPUT_RIGHT };
+                agent->input = choices[NextRandom(&agent->seed) % 3];
+                agent->holdTicks = 5 + NextRandom(&agent->seed) % 36;
+            }
+            agent->holdTicks--;
+            input = agent->input;
+            if ((NextRandom(&agent->seed) % (2 * TICK_RATE)) == 0) input |= INPUT_ROTATE;
+        } break;
+        case AGENT_GREEDY: input = GetGreedyInput(agent, state); break;
+        case AGENT_SCRIPT:
+        {
+            if (agent->step >= scriptLength) break;
+            input = script[agent->step].input;
+            if (++agent->stepTicks >= script[agent->step].ticks) {
+                agent->step++;
+                agent->stepTicks = 0;
+            }
+        } break;
+    }
+
+    return input;
+}
+
+// One attempt: enter the room, play until exit, death or timeout
+static void RunAttempt(Worker *worker, int room, unsigned int seed)
+{
+    RoomStats *stats = &worker->rooms[room];
+    GameState state = { 0 };
+    Agent agent = { 0 };
+
+    state.player = GetDefaultPlayer();
+    state.seed = seed;
+    LoadRoom(&state, room);
+
+    agent.type = agentType;
+    agent.seed = seed ^ 0x5bd1e995;
+    agent.lastX = INT_MIN;
+
+    stats->attempts++;
+    for (int tick = 1; tick <= maxTicks; tick++) {
+        int events = UpdateGameState(&state, GetAgentInput(&agent, &state));
+        worker->ticks++;
+
+        if (events & EVENT_EXIT) {
+            stats->exits++;
+            stats->exitTicks += tick;
+            if ((stats->minExitTicks == 0) || (tick < stats->minExitTicks)) stats->minExitTicks = tick;
+            if (tick > stats->maxExitTicks) stats->maxExitTicks = tick;
+            return;
+        }
+        if (events & EVENT_DEATH_HAZARD) { stats->hazardDeaths++; return; }
+        if (events & EVENT_DEATH_OXYGEN) { stats->oxygenDeaths++; return; }
+    }
+    stats->timeouts++;
+}
+
+static void *RunWorker(void *data)
+{
+    Worker *worker = (Worker *)data;
+    long totalAttempts = (long)attemptsPerRoom * NUM_ROOMS;
+    double start = GetSeconds();
+
+    for (long attempt = worker->index; attempt < totalAttempts; attempt += threadCount) {
+        RunAttempt(worker, (int)(attempt % NUM_ROOMS), baseSeed ^ (unsigned int)(attempt * 2654435761u));
+    }
+
+    worker->seconds = GetSeconds() - start;
+    return NULL;
+}
+
+static void PrintReport(float oxygen, float drain)
+{
+    static const char *agentNames[] = { "random", "greedy", "script" };
+    RoomStats total[NUM_ROOMS] = { 0 };
+    long ticks = 0;
+    double wallSeconds = 0.0;
+
+    for (int t = 0; t < threadCount; t++) {
+        for (int r = 0; r < NUM_ROOMS; r++) {
+            const RoomStats *stats = &workers[t].rooms[r];
+            total[r].attempts += stats->attempts;
+            total[r].exits += stats->exits;
+            total[r].hazardDeaths += stats->hazardDeaths;
+            total[r].oxygenDeaths += stats->oxygenDeaths;
+            total[r].timeouts += stats->timeouts;
+            total[r].exitTicks += stats->exitTicks;
+            if ((stats->minExitTicks > 0) && ((total[r].minExitTicks == 0) || (stats->minExitTicks < total[r].minExitTicks))) total[r].minExitTicks = stats->minExitTicks;
+            if (stats->maxExitTicks > total[r].maxExitTicks) total[r].maxExitTicks = stats->maxExitTicks;
+        }
+        ticks += workers[t].ticks;
+        if (workers[t].seconds > wallSeconds) wallSeconds = workers[t].seconds;
+    }
+
+    printf("Playtest: agent %s, %d threads, %d attempts per room, oxygen %.1f, drain %.1f/s\n\n",
+           agentNames[agentType], threadCount, attemptsPerRoom, oxygen, drain);
+    printf("room  attempts   exit%%   exit s avg/min/max       hazard   oxygen  timeout\n");
+    for (int r = 0; r < NUM_ROOMS; r++) {
+        const RoomStats *stats = &total[r];
+        double exitRate = (stats->attempts > 0) ? 100.0 * stats->exits / stats->attempts : 0.0;
+        double avgExit = (stats->exits > 0) ? (double)stats->exitTicks / stats->exits / TICK_RATE : 0.0;
+        printf("%4d  %8ld  %6.1f   %6.2f/%6.2f/%6.2f  %8ld %8ld %8ld\n", r, stats->attempts, exitRate,
+               avgExit, (double)stats->minExitTicks / TICK_RATE, (double)stats->maxExitTicks / TICK_RATE,
+               stats->hazardDeaths, stats->oxygenDeaths, stats->timeouts);
+    }
+
+    printf("\n");
+    for (int t = 0; t < threadCount; t++) {
+        double rate = (workers[t].seconds > 0.0) ? workers[t].ticks / workers[t].seconds : 0.0;
+        printf("thread %3d: %10ld ticks in %7.3f s, %12.0f ticks/s\n", t, workers[t].ticks, workers[t].seconds, rate);
+    }
+    printf("total:      %10ld ticks in %7.3f s, %12.0f ticks/s (%.1f game hours)\n", ticks, wallSeconds,
+           (wallSeconds > 0.0) ? ticks / wallSeconds : 0.0, (double)ticks / TICK_RATE / 3600.0);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    float oxygen = MAX_OXYGEN;
+    float drain = OXYGEN_DRAIN;
+    const char *scriptFile = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (value == NULL) {
+            fprintf(stderr, "playtest: missing value for %s\n", arg);
+            return 1;
+        }
+        i++;
+
+        if (strcmp(arg, "--agent") == 0) {
+            if (strcmp(value, "random") == 0) agentType = AGENT_RANDOM;
+            else if (strcmp(value, "greedy") == 0) agentType = AGENT_GREEDY;
+            else if (strcmp(value, "script") == 0) agentType = AGENT_SCRIPT;
+            else {
+                fprintf(stderr, "playtest: unknown agent %s\n", value);
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--script") == 0) scriptFile = value;
+        else if (strcmp(arg, "--attempts") == 0) attemptsPerRoom = atoi(value);
+        else if (strcmp(arg, "--threads") == 0) threadCount = atoi(value);
+        else if (strcmp(arg, "--max-ticks") == 0) maxTicks = atoi(value);
+        else if (strcmp(arg, "--oxygen") == 0) oxygen = (float)atof(value);
+        else if (strcmp(arg, "--drain") == 0) drain = (float)atof(value);
+        else if (strcmp(arg, "--seed") == 0) baseSeed = (unsigned int)strtoul(value, NULL, 10);
+        else {
+            fprintf(stderr, "playtest: unknown option %s\n", arg);
+            return 1;
+        }
+    }
+
+    if ((agentType == AGENT_SCRIPT) && ((scriptFile == NULL) || !ParseScript(scriptFile))) {
+        fprintf(stderr, "playtest: script agent needs a valid --script file\n");
+        return 1;
+    }
+
+    if (threadCount <= 0) threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threadCount <= 0) threadCount = 1;
+    if (threadCount > MAX_THREADS) threadCount = MAX_THREADS;
+
+    SetSimulationOxygen(oxygen, drain);
+
+    for (int t = 0; t < threadCount; t++) {
+        workers[t].index = t;
+        pthread_create(&workers[t].thread, NULL, RunWorker, &workers[t]);
+    }
+    for (int t = 0; t < threadCount; t++) pthread_join(workers[t].thread, NULL);
+
+    PrintReport(oxygen, drain);
+
+    return 0;
+}
@@ -0,0 +1,434 @@
+/**********************************************************************************************
+*
+*   Preload Functions Definitions
+*
+*   Jobs live in a small fixed table guarded by one mutex; workers sleep on a condition
+*   variable and take the oldest queued job. Collecting a job nobody started yet runs it
+*   on the calling thread instead of waiting behind the others, collecting a running job
+*   waits for it. A collected slot is free again, so a screen can queue its files every
+*   time it is about to be shown.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "preload.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#define PRELOAD_MAX_JOBS 32
+#define PRELOAD_MAX_PATH 256
+#define STARTUP_MAX_ENTRIES 64
+#define STARTUP_NAME_SIZE 48
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum _PreloadType {
+    PRELOAD_IMAGE,
+    PRELOAD_WAVE,
+    PRELOAD_TASK
+} PreloadType;
+
+typedef enum _PreloadState {
+    JOB_FREE = 0,
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE
+} PreloadState;
+
+typedef struct _PreloadJob {
+    PreloadState state;
+    PreloadType type;
+    unsigned int order;             // Queued jobs run oldest first
+    char name[PRELOAD_MAX_PATH];
+    void (*task)(void);
+    Image image;
+    Wave wave;
+} PreloadJob;
+
+typedef struct _StartupEntry {
+    char name[STARTUP_NAME_SIZE];
+    int thread;                     // 0 is the main thread, workers count from 1
+    double start;
+    double end;
+} StartupEntry;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static PreloadJob jobs[PRELOAD_MAX_JOBS] = { 0 };
+static unsigned int nextOrder = 0;
+
+static StartupEntry timeline[STARTUP_MAX_ENTRIES] = { 0 };
+static int timelineCount = 0;
+static double startTime = 0.0;
+static const char *phaseName = NULL;
+static double phaseStart = 0.0;
+
+#if !defined(PLATFORM_WEB)
+static pthread_t workers[PRELOAD_MAX_WORKERS];
+static int workerCount = 0;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;     // A job was queued
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER;     // A job finished
+static pthread_mutex_t decodeLock = PTHREAD_MUTEX_INITIALIZER;  // See LockDecode()
+static bool quit = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void LockJobs(void)
+{
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_lock(&lock);
+#endif
+}
+
+static void UnlockJobs(void)
+{
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_unlock(&lock);
+#endif
+}
+
+static double GetMonotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Called with the jobs locked
+static void AddTimelineEntry(const char *prefix, const char *name, int thread, double start, double end)
+{
+    if (timelineCount >= STARTUP_MAX_ENTRIES) return;
+
+    StartupEntry *entry = &timeline[timelineCount++];
+    snprintf(entry->name, STARTUP_NAME_SIZE, "%s%s", prefix, name);
+    entry->thread = thread;
+    entry->start = start - startTime;
+    entry->end = end - startTime;
+}
+
+static PreloadJob *FindJob(const char *name, PreloadType type)
+{
+    for (int i = 0; i < PRELOAD_MAX_JOBS; i++) {
+        if ((jobs[i].state != JOB_FREE) && (jobs[i].type == type) && (strcmp(jobs[i].name, name) == 0)) return &jobs[i];
+    }
+    return NULL;
+}
+
+static PreloadJob *GetNextJob(void)
+{
+    PreloadJob *next = NULL;
+
+    for (int i = 0; i < PRELOAD_MAX_JOBS; i++) {
+        if ((jobs[i].state == JOB_QUEUED) && ((next == NULL) || ((int)(jobs[i].order - next->order) < 0))) next = &jobs[i];
+    }
+    return next;
+}
+
+// Whole file in one block, plain stdio so several workers can read at once
+static unsigned char *ReadJobFile(const char *fileName, int *size)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    unsigned char *data = NULL;
+    long length = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+
+    if ((length > 0) && (fseek(file, 0, SEEK_SET) == 0)) {
+        data = (unsigned char *)malloc(length);
+        if ((data != NULL) && (fread(data, 1, length, file) != (size_t)length)) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    *size = (int)length;
+    return data;
+}
+
+// File reads run in parallel, the raylib decode under LockDecode(). No GL here, the
+// collecting thread tracks and uploads the result
+static void RunJob(PreloadJob *job)
+{
+    if (job->type == PRELOAD_TASK) {
+        job->task();
+        return;
+    }
+
+    int size = 0;
+    unsigned char *data = ReadJobFile(job->name, &size);
+    if (data == NULL) {
+        TraceLog(LOG_WARNING, "PRELOAD: [%s] Failed to read the file", job->name);
+        return;
+    }
+
+    LockDecode();
+    if (job->type == PRELOAD_IMAGE) job->image = LoadImageFromMemory(GetFileExtension(job->name), data, size);
+    else if (job->type == PRELOAD_WAVE) job->wave = LoadWaveFromMemory(GetFileExtension(job->name), data, size);
+    UnlockDecode();
+
+    free(data);
+}
+
+static void QueueJob(const char *name, PreloadType type, void (*task)(void))
+{
+    if (strlen(name) >= PRELOAD_MAX_PATH) return;
+
+    LockJobs();
+    if (FindJob(name, type) == NULL) {
+        PreloadJob *job = NULL;
+
+        for (int i = 0; (i < PRELOAD_MAX_JOBS) && (job == NULL); i++) {
+            if (jobs[i].state == JOB_FREE) job = &jobs[i];
+        }
+
+        if (job == NULL) TraceLog(LOG_WARNING, "PRELOAD: [%s] Job table full, loaded when needed", name);
+        else {
+            *job = (PreloadJob){ 0 };
+            job->state = JOB_QUEUED;
+            job->type = type;
+            job->order = nextOrder++;
+            job->task = task;
+            strcpy(job->name, name);
+#if !defined(PLATFORM_WEB)
+            pthread_cond_signal(&wake);
+#endif
+        }
+    }
+    UnlockJobs();
+}
+
+// Takes the job out of the table once it is done, false when it was never queued
+static bool CollectJob(const char *name, PreloadType type, PreloadJob *collected)
+{
+    LockJobs();
+
+    PreloadJob *job = FindJob(name, type);
+    if (job == NULL) {
+        UnlockJobs();
+        return false;
+    }
+
+    double start = GetMonotonicTime();
+
+    if (job->state == JOB_QUEUED) {
+        job->state = JOB_RUNNING;
+        UnlockJobs();
+        RunJob(job);
+        LockJobs();
+        AddTimelineEntry("", GetFileName(job->name), 0, start, GetMonotonicTime());
+        job->state = JOB_DONE;
+    }
+#if !defined(PLATFORM_WEB)
+    else if (job->state == JOB_RUNNING) {
+        while (job->state != JOB_DONE) pthread_cond_wait(&done, &lock);
+        AddTimelineEntry("wait ", GetFileName(job->name), 0, start, GetMonotonicTime());
+    }
+#endif
+
+    *collected = *job;
+    job->state = JOB_FREE;
+    UnlockJobs();
+
+    return true;
+}
+
+#if !defined(PLATFORM_WEB)
+static void *RunPreloadWorker(void *data)
+{
+    int thread = (int)(intptr_t)data;
+
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        PreloadJob *job = NULL;
+
+        while (!quit && ((job = GetNextJob()) == NULL)) pthread_cond_wait(&wake, &lock);
+        if (quit) break;
+
+        job->state = JOB_RUNNING;
+        pthread_mutex_unlock(&lock);
+
+        double start = GetMonotonicTime();
+        RunJob(job);
+        double end = GetMonotonicTime();
+
+        pthread_mutex_lock(&lock);
+        AddTimelineEntry("", GetFileName(job->name), thread, start, end);
+        job->state = JOB_DONE;
+        pthread_cond_broadcast(&done);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Preload Functions Definition
+//----------------------------------------------------------------------------------
+void InitPreload(void)
+{
+    startTime = GetMonotonicTime();
+
+#if !defined(PLATFORM_WEB)
+    // One core stays with the main thread, but at least two workers: opening the audio
+    // device mostly waits on the driver and should not hold up decoding
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (count < 2) count = 2;
+    if (count > PRELOAD_MAX_WORKERS) count = PRELOAD_MAX_WORKERS;
+
+    quit = false;
+    for (workerCount = 0; workerCount < count; workerCount++) {
+        if (pthread_create(&workers[workerCount], NULL, RunPreloadWorker, (void *)(intptr_t)(workerCount + 1)) != 0) break;
+    }
+    if (workerCount == 0) TraceLog(LOG_WARNING, "PRELOAD: Worker threads failed, assets load when needed");
+#endif
+}
+
+void ClosePreload(void)
+{
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_lock(&lock);
+    quit = true;
+    pthread_cond_broadcast(&wake);
+    pthread_mutex_unlock(&lock);
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i], NULL);
+    workerCount = 0;
+#endif
+
+    // Never collected, so never tracked either
+    for (int i = 0; i < PRELOAD_MAX_JOBS; i++) {
+        if (jobs[i].state == JOB_DONE) {
+            if (jobs[i].type == PRELOAD_IMAGE) UnloadImage(jobs[i].image);
+            else if (jobs[i].type == PRELOAD_WAVE) UnloadWave(jobs[i].wave);
+        }
+        jobs[i].state = JOB_FREE;
+    }
+}
+
+// One raylib file load at a time in the whole game: the loaders check file types with
+// helpers that share static buffers (TextToLower(), IsFileExtension())
+void LockDecode(void)
+{
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_lock(&decodeLock);
+#endif
+}
+
+void UnlockDecode(void)
+{
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_unlock(&decodeLock);
+#endif
+}
+
+void PreloadImage(const char *fileName)
+{
+    QueueJob(fileName, PRELOAD_IMAGE, NULL);
+}
+
+void PreloadWave(const char *fileName)
+{
+    QueueJob(fileName, PRELOAD_WAVE, NULL);
+}
+
+void PreloadTask(const char *name, void (*task)(void))
+{
+    QueueJob(name, PRELOAD_TASK, task);
+}
+
+void WaitPreloadTask(const char *name)
+{
+    PreloadJob job = { 0 };
+    CollectJob(name, PRELOAD_TASK, &job);
+}
+
+Image GetPreloadedImage(const char *fileName)
+{
+    PreloadJob job = { 0 };
+
+    if (!CollectJob(fileName, PRELOAD_IMAGE, &job)) return LoadImageTracked(fileName);
+
+    TrackMemory(MEMORY_IMAGE, (uintptr_t)job.image.data, (size_t)GetPixelDataSize(job.image.width, job.image.height, job.image.format), GetFileName(fileName));
+    return job.image;
+}
+
+Sound GetPreloadedSound(const char *fileName)
+{
+    PreloadJob job = { 0 };
+
+    if (!CollectJob(fileName, PRELOAD_WAVE, &job)) return LoadSoundTracked(fileName);
+
+    Sound sound = LoadSoundFromWaveTracked(job.wave, fileName);
+    UnloadWave(job.wave);
+    return sound;
+}
+
+void BeginStartupPhase(const char *name)
+{
+    phaseName = name;
+    phaseStart = GetMonotonicTime();
+}
+
+void EndStartupPhase(void)
+{
+    if (phaseName == NULL) return;
+
+    LockJobs();
+    AddTimelineEntry("", phaseName, 0, phaseStart, GetMonotonicTime());
+    UnlockJobs();
+    phaseName = NULL;
+}
+
+void MarkStartup(const char *name)
+{
+    double now = GetMonotonicTime();
+
+    LockJobs();
+    AddTimelineEntry("", name, 0, now, now);
+    UnlockJobs();
+}
+
+void TraceStartupTimeline(void)
+{
+    StartupEntry sorted[STARTUP_MAX_ENTRIES];
+
+    LockJobs();
+    int count = timelineCount;
+    memcpy(sorted, timeline, count * sizeof(StartupEntry));
+    UnlockJobs();
+
+    // Entries are added as they end, list them as they started
+    for (int i = 1; i < count; i++) {
+        StartupEntry entry = sorted[i];
+        int j = i - 1;
+
+        while ((j >= 0) && (sorted[j].start > entry.start)) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = entry;
+    }
+
+    TraceLog(LOG_INFO, "STARTUP: Timeline, milliseconds since launch");
+    for (int i = 0; i < count; i++) {
+        const StartupEntry *entry = &sorted[i];
+
+        if (entry->thread == 0) TraceLog(LOG_INFO, "STARTUP: %8.1f +%7.1f  main    %s", entry->start * 1000.0, (entry->end - entry->start) * 1000.0, entry->name);
+        else TraceLog(LOG_INFO, "STARTUP: %8.1f +%7.1f  job %i   %s", entry->start * 1000.0, (entry->end - entry->start) * 1000.0, entry->thread, entry->name);
+    }
+}
@@ -0,0 +1,55 @@
+/**********************************************************************************************
+*
+*   Asset Preloading
+*
+*   A few worker threads decode images and waves ahead of the screens that need them and
+*   run slow one-off startup work (the audio device), so the window shows its first frame
+*   right away and screen inits only upload. Workers read files in parallel but decode
+*   one at a time, raylib's loaders are not thread-safe: every raylib call that loads or
+*   exports a file by its type (LoadImage, LoadSound, LoadMusicStream, LoadFont,
+*   ExportImage...) goes between LockDecode() and UnlockDecode(), on any thread. The
+*   memtrack loaders do it already. Workers never touch GL or memory
+*   tracking: GetPreloadedImage() and GetPreloadedSound() hand the decoded data to the
+*   calling thread, which tracks and uploads it. A file that was never queued is loaded
+*   there and then, like LoadImageTracked() / LoadSoundTracked().
+*
+*   The startup timeline records when each phase and each job ran, on which thread;
+*   TraceStartupTimeline() logs it.
+*
+*   On PLATFORM_WEB there are no threads, jobs run when they are collected.
+*
+**********************************************************************************************/
+
+#ifndef PRELOAD_H
+#define PRELOAD_H
+
+#define PRELOAD_MAX_WORKERS 4
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Preload Functions Declaration
+//----------------------------------------------------------------------------------
+void InitPreload(void);                                     // First thing in main(), the timeline starts here
+void ClosePreload(void);                                    // Waits for running jobs, frees what was never collected
+void PreloadImage(const char *fileName);                    // Queue decoding, a file already queued is skipped
+void PreloadWave(const char *fileName);
+void PreloadTask(const char *name, void (*task)(void));     // Any other work, no raylib calls needing the GL context
+void WaitPreloadTask(const char *name);
+Image GetPreloadedImage(const char *fileName);              // Waits for the decode, the image is tracked from here on
+Sound GetPreloadedSound(const char *fileName);              // Waits for the decode, needs the audio device
+void LockDecode(void);                                      // Around raylib file loads while workers may run
+void UnlockDecode(void);
+
+void BeginStartupPhase(const char *name);                   // Main thread phases, not nested
+void EndStartupPhase(void);
+void MarkStartup(const char *name);                         // Single point in time (first frame...)
+void TraceStartupTimeline(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRELOAD_H
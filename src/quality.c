@@ -0,0 +1,154 @@
+/**********************************************************************************************
+*
+*   Quality Governor Functions Definitions
+*
+*   A frame is slow when its work takes most of the budget and late when it was presented
+*   well after the expected interval, which also catches GPU time the work measure can
+*   not see (it waits in the swap). Without a deadline (uncapped pacing) the budget is
+*   60 fps. A window has headroom when no frame was slow or late and even the slowest
+*   work used under half the budget.
+*
+*   MSAA and render scale are no levels: pixel art renders at its native size into the
+*   display target without MSAA, there is nothing cheaper to fall back to.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "quality.h"
+#include "pacing.h"
+#include "gameplay.h"
+#include "screens.h"
+
+#define QUALITY_DEFAULT_BUDGET (1.0 / 60.0)
+#define QUALITY_SLOW_WORK 0.85          // Share of the budget over which a frame is slow
+#define QUALITY_LATE_FACTOR 1.5         // Interval over budget * factor is late, like a missed frame
+#define QUALITY_DOWN_FRAMES 6           // Slow or late frames in a window that step down
+#define QUALITY_HEADROOM_WORK 0.5       // Share of the budget the slowest work stays under
+#define QUALITY_UP_WINDOWS 3            // Windows with headroom before stepping up
+#define QUALITY_MAX_UP_WINDOWS 48
+#define QUALITY_BOUNCE_WINDOWS 2        // Stepping down this soon after up doubles the wait
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _QualitySettings {
+    const char *name;
+    int particleBudget;
+    LightingDetail lighting;
+    bool background;
+} QualitySettings;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const QualitySettings settings[QUALITY_LEVELS] = {
+    { "unlit", MAX_PARTICLES / 128, LIGHTING_OFF, false },
+    { "no background", MAX_PARTICLES / 32, LIGHTING_COARSE, false },
+    { "coarse lighting", MAX_PARTICLES / 8, LIGHTING_COARSE, true },
+    { "fewer particles", MAX_PARTICLES / 8, LIGHTING_FULL, true },
+    { "full", MAX_PARTICLES, LIGHTING_FULL, true },
+};
+
+static int level = QUALITY_LEVELS - 1;
+static bool automatic = true;
+
+static int frames = 0;                  // In the current window
+static int slowFrames = 0;
+static float maxWork = 0.0f;
+static int windows = 0;
+static int headroomWindows = 0;         // In a row
+static int upWindows = QUALITY_UP_WINDOWS;
+static int lastUpWindow = -QUALITY_MAX_UP_WINDOWS;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void ApplyQualityLevel(int newLevel)
+{
+    level = newLevel;
+    SetParticleBudget(settings[level].particleBudget);
+    SetLightingDetail(settings[level].lighting);
+    SetGameplayBackgroundDetail(settings[level].background);
+}
+
+static void ResetQualityWindow(void)
+{
+    frames = 0;
+    slowFrames = 0;
+    maxWork = 0.0f;
+}
+
+//----------------------------------------------------------------------------------
+// Quality Governor Functions Definition
+//----------------------------------------------------------------------------------
+void InitQualityGovernor(void)
+{
+    automatic = true;
+    windows = 0;
+    headroomWindows = 0;
+    upWindows = QUALITY_UP_WINDOWS;
+    lastUpWindow = -QUALITY_MAX_UP_WINDOWS;
+    ResetQualityWindow();
+    ApplyQualityLevel(QUALITY_LEVELS - 1);
+}
+
+void UpdateQualityGovernor(void)
+{
+    if (!automatic) return;
+
+    double budget = GetFramePacingBudget();
+    float work = GetFrameWorkTime();
+
+    if (budget <= 0.0) budget = QUALITY_DEFAULT_BUDGET;
+    if ((work > budget * QUALITY_SLOW_WORK) || (GetFramePresentInterval() > budget * QUALITY_LATE_FACTOR)) slowFrames++;
+    if (work > maxWork) maxWork = work;
+    if (++frames < QUALITY_WINDOW) return;
+
+    windows++;
+    if ((slowFrames >= QUALITY_DOWN_FRAMES) && (level > 0)) {
+        if ((windows - lastUpWindow <= QUALITY_BOUNCE_WINDOWS) && (upWindows < QUALITY_MAX_UP_WINDOWS)) upWindows *= 2;
+
+        ApplyQualityLevel(level - 1);
+        headroomWindows = 0;
+        TraceLog(LOG_INFO, "QUALITY: Down to %s, %i of %i frames over %.1f ms", settings[level].name, slowFrames, frames, budget * 1000.0);
+    }
+    else if ((slowFrames == 0) && (maxWork < budget * QUALITY_HEADROOM_WORK)) {
+        if ((++headroomWindows >= upWindows) && (level < QUALITY_LEVELS - 1)) {
+            ApplyQualityLevel(level + 1);
+            headroomWindows = 0;
+            lastUpWindow = windows;
+            TraceLog(LOG_INFO, "QUALITY: Up to %s, slowest work %.1f ms", settings[level].name, maxWork * 1000.0f);
+        }
+    }
+    else headroomWindows = 0;
+
+    ResetQualityWindow();
+}
+
+void SetQualityLevel(int newLevel)
+{
+    automatic = (newLevel < 0);
+    headroomWindows = 0;
+    ResetQualityWindow();
+
+    if (!automatic) {
+        ApplyQualityLevel((newLevel < QUALITY_LEVELS) ? newLevel : QUALITY_LEVELS - 1);
+        TraceLog(LOG_INFO, "QUALITY: Fixed at %s", settings[level].name);
+    }
+    else TraceLog(LOG_INFO, "QUALITY: Automatic");
+}
+
+int GetQualityLevel(void)
+{
+    return level;
+}
+
+bool IsQualityAutomatic(void)
+{
+    return automatic;
+}
+
+void DrawQualityStatus(int posX, int posY)
+{
+    DrawText(TextFormat("quality %s%s", settings[level].name, automatic ? " (auto)" : ""), posX, posY, 10, LIME);
+}
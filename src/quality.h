@@ -0,0 +1,41 @@
+/**********************************************************************************************
+*
+*   Quality Governor
+*
+*   Holds the frame rate on machines that can not afford everything. The frame work
+*   (update and draw, from frame pacing) and the present interval are collected over
+*   windows of QUALITY_WINDOW frames: a window with too many slow or late frames steps the
+*   quality down one level right away, stepping back up takes several windows with
+*   plenty of headroom. A level left again shortly after stepping up to it waits twice as
+*   long before the next try, so the governor does not keep bouncing on the edge.
+*
+*   Levels, from the top: everything; fewer particles; one lightmap texel per tile; no
+*   background tiles; unlit with few particles.
+*
+**********************************************************************************************/
+
+#ifndef QUALITY_H
+#define QUALITY_H
+
+#define QUALITY_LEVELS 5
+#define QUALITY_WINDOW 60               // Frames per decision
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Quality Governor Functions Declaration
+//----------------------------------------------------------------------------------
+void InitQualityGovernor(void);                 // Automatic, from the top level
+void UpdateQualityGovernor(void);               // Every frame, after EndFramePacing()
+void SetQualityLevel(int level);                // Fixed level, -1 back to automatic
+int GetQualityLevel(void);                      // 0 lowest, QUALITY_LEVELS - 1 everything
+bool IsQualityAutomatic(void);
+void DrawQualityStatus(int posX, int posY);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUALITY_H
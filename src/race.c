@@ -0,0 +1,471 @@
+/**********************************************************************************************
+*
+*   Race Functions Definitions
+*
+*   Everything a tick changes lives in RaceState, a plain copy: the two players with their
+*   respawn points, their cleared rooms and the tick. Going back is one assignment from the
+*   history, going forward is UpdateGameState() on both players again, so a rollback costs
+*   about as many ticks as it replays and nothing outside RaceState may change in a tick
+*   (no timers, no telemetry, no rewind buffer). The local player never depends on the
+*   opponent, what gets corrected is the opponent and the result.
+*
+*   Every packet carries the local inputs the opponent did not acknowledge yet, so a lost
+*   packet is covered by the next one.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "race.h"
+#include <string.h>
+
+#if !defined(PLATFORM_WEB) && !defined(_WIN32)
+    #define RACE_SOCKETS
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#define RACE_MAGIC 0x45434152           // "RACE"
+#define RACE_HISTORY 32                 // Ticks kept, power of two: RACE_MAX_ROLLBACK behind, as many ahead
+#define RACE_TIMEOUT 5.0                // Seconds without a packet before the opponent is gone
+#define RACE_MAX_LAG 0.25               // Seconds behind before ticks are dropped instead of caught up
+#define RACE_SYNC_TICKS 2               // Lead over the opponent that makes this side skip a tick
+#define RACE_SYNC_INTERVAL 10           // Ticks at least between two skipped ticks
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum _PacketType {
+    PACKET_HELLO = 0,                   // Joining, until PACKET_START arrives
+    PACKET_START,                       // Answer from the host, with the seed
+    PACKET_INPUT
+} PacketType;
+
+typedef struct _RacePacket {
+    unsigned int magic;
+    unsigned int type;
+    unsigned int seed;
+    unsigned int tick;                  // Ticks simulated by the sender, its inputs end there
+    unsigned int ack;                   // Inputs the sender received so far
+    int advantage;                      // Sender ticks past the inputs it received
+    unsigned int count;
+    unsigned char inputs[RACE_MAX_ROLLBACK];
+} RacePacket;
+
+typedef struct _RacePlayer {
+    GameState state;
+    GameState respawn;                  // Set on every room exit, restored on death
+    int rooms;                          // Cleared so far
+    int finishTick;                     // Tick that cleared the last room, -1 while racing
+} RacePlayer;
+
+typedef struct _RaceState {
+    RacePlayer players[2];              // Host first
+    unsigned int tick;                  // Ticks simulated
+} RaceState;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static RaceStatus status = RACE_WAITING;
+static int local = 0;                   // Player index of this instance, the host is 0
+static GameState start = { 0 };
+static unsigned int seed = 0;
+static double nextTickTime = 0.0;
+static double lastReceived = 0.0;
+static unsigned int lastSkipTick = 0;
+
+#if defined(RACE_SOCKETS)
+static int raceSocket = -1;
+static struct sockaddr_in peer = { 0 };
+#endif
+
+static RaceState race = { 0 };                              // The present
+static RaceState history[RACE_HISTORY] = { 0 };             // State before each tick
+static unsigned char inputs[2][RACE_HISTORY] = { 0 };       // Used by each tick, predicted for the opponent from remoteTicks
+static unsigned int remoteTicks = 0;    // Opponent inputs received, the ticks before are final
+static unsigned int remoteAck = 0;      // Local inputs the opponent received
+static int remoteAdvantage = 0;
+static int remoteInput = INPUT_NONE;    // Latest received, the prediction for the ticks after
+
+static GameSnapshot snapshot = { 0 };
+
+static unsigned int rollbacks = 0;
+static unsigned int replayedTicks = 0;
+static int maxRollbackTicks = 0;
+static double maxRollbackTime = 0.0;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int StepRacePlayer(RacePlayer *player, int input, unsigned int tick, Vector2 *deathPosition)
+{
+    if (player->finishTick >= 0) return EVENT_NONE;
+
+    int low = GetSimulationOxygenWarning();
+    bool above = (player->state.player.oxygen > low);
+    int events = UpdateGameState(&player->state, input);
+
+    // No timer wheel here, the crossing is found tick by tick
+    if (above && (player->state.player.oxygen <= low)) events |= EVENT_OXYGEN_LOW;
+
+    if (events & EVENT_EXIT) {
+        player->respawn = player->state;
+        player->rooms++;
+        if (player->rooms >= RACE_ROOMS) player->finishTick = (int)tick;
+    }
+    if (events & EVENT_DEATH) {
+        *deathPosition = GetPlayerPosition(&player->state.player);
+        player->state = player->respawn;
+    }
+    return events;
+}
+
+// One tick on both players from the inputs table, returns the local events
+static int SimulateTick(Vector2 *deathPosition)
+{
+    unsigned int slot = race.tick % RACE_HISTORY;
+    Vector2 remoteDeath = { 0 };
+    int events = EVENT_NONE;
+
+    history[slot] = race;
+    for (int p = 0; p < 2; p++) {
+        if (p == local) events = StepRacePlayer(&race.players[p], inputs[p][slot], race.tick, deathPosition);
+        else StepRacePlayer(&race.players[p], inputs[p][slot], race.tick, &remoteDeath);
+    }
+    race.tick++;
+
+    return events;
+}
+
+static void RollBack(unsigned int tick)
+{
+    double startTime = GetTime();
+    unsigned int present = race.tick;
+    Vector2 deathPosition = { 0 };
+
+    race = history[tick % RACE_HISTORY];
+    while (race.tick < present) SimulateTick(&deathPosition);
+
+    double elapsed = GetTime() - startTime;
+    int ticks = (int)(present - tick);
+
+    rollbacks++;
+    replayedTicks += ticks;
+    if (ticks > maxRollbackTicks) maxRollbackTicks = ticks;
+    if (elapsed > maxRollbackTime) maxRollbackTime = elapsed;
+}
+
+static void StartRace(double now)
+{
+    race = (RaceState){ 0 };
+    for (int p = 0; p < 2; p++) {
+        RacePlayer *player = &race.players[p];
+
+        player->state = start;
+        player->state.seed = seed;
+        player->state.rotations = 0;
+        LoadRoom(&player->state, 0);
+        player->respawn = player->state;
+        player->finishTick = -1;
+    }
+
+    memset(inputs, 0, sizeof(inputs));
+    remoteTicks = 0;
+    remoteAck = 0;
+    remoteAdvantage = 0;
+    remoteInput = INPUT_NONE;
+
+    snapshot = (GameSnapshot){ 0 };
+    snapshot.state = race.players[local].state;
+    snapshot.deathPosition = GetPlayerPosition(&snapshot.state.player);
+
+    ClearGameInput();
+    nextTickTime = now + SIM_TICK_TIME;
+    lastReceived = now;
+    lastSkipTick = 0;
+    status = RACE_RUNNING;
+    TraceLog(LOG_INFO, "RACE: Started as player %i, seed %u", local + 1, seed);
+}
+
+static void AddRemoteInputs(const RacePacket *packet)
+{
+    unsigned int first = packet->tick - packet->count;
+    unsigned int rollback = race.tick;
+
+    for (unsigned int t = first; t < packet->tick; t++) {
+        if (t < remoteTicks) continue;
+        if ((t > remoteTicks) || (t >= race.tick + RACE_HISTORY - RACE_MAX_ROLLBACK)) break;
+
+        int input = packet->inputs[t - first];
+
+        if ((t < race.tick) && (inputs[1 - local][t % RACE_HISTORY] != input) && (t < rollback)) rollback = t;
+        inputs[1 - local][t % RACE_HISTORY] = (unsigned char)input;
+        remoteInput = input;
+        remoteTicks = t + 1;
+    }
+
+    // Ticks still predicted now hold the newest input
+    for (unsigned int t = remoteTicks; t < race.tick; t++) {
+        if (inputs[1 - local][t % RACE_HISTORY] != remoteInput) {
+            if (t < rollback) rollback = t;
+            inputs[1 - local][t % RACE_HISTORY] = (unsigned char)remoteInput;
+        }
+    }
+
+    if (packet->ack > remoteAck) remoteAck = packet->ack;
+    remoteAdvantage = packet->advantage;
+    if (rollback < race.tick) RollBack(rollback);
+}
+
+#if defined(RACE_SOCKETS)
+static bool BindRacePort(int port)
+{
+    struct sockaddr_in address = { 0 };
+
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    return (bind(raceSocket, (struct sockaddr *)&address, sizeof(address)) == 0);
+}
+#endif
+
+static void SendPacket(PacketType type)
+{
+#if defined(RACE_SOCKETS)
+    RacePacket packet = { 0 };
+
+    packet.magic = RACE_MAGIC;
+    packet.type = type;
+    packet.seed = seed;
+    packet.tick = race.tick;
+    packet.ack = remoteTicks;
+    packet.advantage = (int)(race.tick - remoteTicks);
+
+    // Everything not acknowledged, never more than RACE_MAX_ROLLBACK as ticks wait for the acks
+    if (type == PACKET_INPUT) {
+        unsigned int first = remoteAck;
+        if (race.tick - first > RACE_MAX_ROLLBACK) first = race.tick - RACE_MAX_ROLLBACK;
+
+        packet.count = race.tick - first;
+        for (unsigned int t = first; t < race.tick; t++) packet.inputs[t - first] = inputs[local][t % RACE_HISTORY];
+    }
+
+    sendto(raceSocket, &packet, sizeof(packet), 0, (struct sockaddr *)&peer, sizeof(peer));
+#endif
+}
+
+static void ReceivePackets(double now)
+{
+#if defined(RACE_SOCKETS)
+    RacePacket packet = { 0 };
+
+    while (recv(raceSocket, &packet, sizeof(packet), 0) == (int)sizeof(packet)) {
+        if ((packet.magic != RACE_MAGIC) || (packet.count > RACE_MAX_ROLLBACK) || (packet.count > packet.tick)) continue;
+
+        lastReceived = now;
+        switch (packet.type) {
+            case PACKET_HELLO:
+            {
+                // Answered every time, a lost start is asked again
+                if (local != 0) break;
+                if (status == RACE_WAITING) StartRace(now);
+                SendPacket(PACKET_START);
+            } break;
+            case PACKET_START:
+            {
+                if ((local != 1) || (status != RACE_WAITING)) break;
+                seed = packet.seed;
+                StartRace(now);
+            } break;
+            case PACKET_INPUT:
+            {
+                if ((status == RACE_RUNNING) || (status == RACE_FINISHED)) AddRemoteInputs(&packet);
+            } break;
+            default: break;
+        }
+    }
+#endif
+}
+
+// Final once a player finished on a tick both inputs are known for
+static RaceResult FindResult(void)
+{
+    int confirmed = (int)((remoteTicks < race.tick) ? remoteTicks : race.tick);
+    int finishLocal = race.players[local].finishTick;
+    int finishRemote = race.players[1 - local].finishTick;
+
+    if ((finishLocal < 0) || (finishLocal >= confirmed)) finishLocal = -1;
+    if ((finishRemote < 0) || (finishRemote >= confirmed)) finishRemote = -1;
+
+    if ((finishLocal < 0) && (finishRemote < 0)) return RACE_UNDECIDED;
+    if (finishLocal == finishRemote) return RACE_DRAW;
+    if ((finishRemote < 0) || ((finishLocal >= 0) && (finishLocal < finishRemote))) return RACE_WON;
+    return RACE_LOST;
+}
+
+//----------------------------------------------------------------------------------
+// Race Functions Definition
+//----------------------------------------------------------------------------------
+bool OpenRaceSession(const GameState *state)
+{
+    start = *state;
+    seed = state->seed;
+    status = RACE_WAITING;
+    race = (RaceState){ 0 };
+    snapshot = (GameSnapshot){ 0 };
+    snapshot.state = *state;
+    snapshot.deathPosition = GetPlayerPosition(&state->player);
+    rollbacks = 0;
+    replayedTicks = 0;
+    maxRollbackTicks = 0;
+    maxRollbackTime = 0.0;
+
+#if defined(RACE_SOCKETS)
+    raceSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (raceSocket < 0) {
+        TraceLog(LOG_WARNING, "RACE: Could not create a socket");
+        return false;
+    }
+    fcntl(raceSocket, F_SETFL, fcntl(raceSocket, F_GETFL, 0) | O_NONBLOCK);
+
+    if (BindRacePort(RACE_PORT)) local = 0;
+    else if (BindRacePort(RACE_PORT + 1)) local = 1;
+    else {
+        TraceLog(LOG_WARNING, "RACE: Ports %i and %i are both taken", RACE_PORT, RACE_PORT + 1);
+        close(raceSocket);
+        raceSocket = -1;
+        return false;
+    }
+
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons((unsigned short)(RACE_PORT + 1 - local));
+    peer.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    TraceLog(LOG_INFO, "RACE: Listening on port %i, waiting for player %i", RACE_PORT + local, 2 - local);
+    return true;
+#else
+    TraceLog(LOG_WARNING, "RACE: Not available on this platform");
+    return false;
+#endif
+}
+
+void CloseRaceSession(void)
+{
+#if defined(RACE_SOCKETS)
+    if (raceSocket < 0) return;
+    close(raceSocket);
+    raceSocket = -1;
+#endif
+
+    if (race.tick > 0) {
+        TraceLog(LOG_INFO, "RACE: %u ticks, %u rollbacks replaying %u ticks, deepest %i ticks, slowest %.3f ms",
+                 race.tick, rollbacks, replayedTicks, maxRollbackTicks, maxRollbackTime * 1000.0);
+    }
+}
+
+void UpdateRace(void)
+{
+    double now = GetTime();
+
+    ReceivePackets(now);
+
+    if (status == RACE_WAITING) {
+        if (local == 1) SendPacket(PACKET_HELLO);
+        return;
+    }
+    if (status == RACE_DISCONNECTED) return;
+
+    // A finished race keeps its result when the opponent quits
+    if (now - lastReceived > RACE_TIMEOUT) {
+        if (status == RACE_RUNNING) {
+            status = RACE_DISCONNECTED;
+            TraceLog(LOG_WARNING, "RACE: No packets for %.0f seconds, the opponent left", RACE_TIMEOUT);
+        }
+        return;
+    }
+
+    // The side further ahead of the inputs it has skips a tick now and then, so neither
+    // side keeps rolling back because its clock started first
+    int lead = ((int)(race.tick - remoteTicks) - remoteAdvantage) / 2;
+    if ((lead >= RACE_SYNC_TICKS) && (race.tick - lastSkipTick >= RACE_SYNC_INTERVAL)) {
+        nextTickTime += SIM_TICK_TIME;
+        lastSkipTick = race.tick;
+    }
+
+    if (now - nextTickTime > RACE_MAX_LAG) nextTickTime = now;
+    // The opponent may be ahead, so the differences are signed
+    while ((nextTickTime <= now) && ((int)(race.tick - remoteTicks) < RACE_MAX_ROLLBACK) && ((int)(race.tick - remoteAck) < RACE_MAX_ROLLBACK)) {
+        unsigned int slot = race.tick % RACE_HISTORY;
+        Vector2 deathPosition = { 0 };
+
+        inputs[local][slot] = (unsigned char)(ConsumeGameInput(nextTickTime) & ~INPUT_REWIND);
+        if (race.tick >= remoteTicks) inputs[1 - local][slot] = (unsigned char)remoteInput;
+
+        // Replayed ticks come out the same for the local player, only new ones count
+        int events = SimulateTick(&deathPosition);
+
+        for (int k = 0; k < GAME_EVENT_KINDS; k++) {
+            if (events & (1 << k)) snapshot.eventCounts[k]++;
+        }
+        if (events & EVENT_DEATH) snapshot.deathPosition = deathPosition;
+        nextTickTime += SIM_TICK_TIME;
+    }
+
+    snapshot.state = race.players[local].state;
+    snapshot.tick = race.tick;
+
+    SendPacket(PACKET_INPUT);
+    if ((status == RACE_RUNNING) && (FindResult() != RACE_UNDECIDED)) status = RACE_FINISHED;
+}
+
+RaceStatus GetRaceStatus(void)
+{
+    return status;
+}
+
+RaceResult GetRaceResult(void)
+{
+    return (status == RACE_WAITING) ? RACE_UNDECIDED : FindResult();
+}
+
+const GameSnapshot *GetRaceSnapshot(void)
+{
+    return &snapshot;
+}
+
+const GameState *GetRaceOpponent(void)
+{
+    return (status == RACE_WAITING) ? NULL : &race.players[1 - local].state;
+}
+
+void DrawRaceStatus(int posX, int posY)
+{
+    static const char *results[] = { "", "YOU WIN", "YOU LOSE", "DRAW" };
+
+    switch (status) {
+        case RACE_WAITING:
+        {
+            DrawText((local == 0) ? "WAITING FOR PLAYER 2" : "JOINING RACE", posX, posY, 10, RAYWHITE);
+        } break;
+        case RACE_DISCONNECTED:
+        {
+            DrawText("OPPONENT LEFT", posX, posY, 10, RED);
+        } break;
+        default:
+        {
+            int rooms = race.players[local].rooms;
+            int opponentRooms = race.players[1 - local].rooms;
+
+            if (rooms > RACE_ROOMS) rooms = RACE_ROOMS;
+            if (opponentRooms > RACE_ROOMS) opponentRooms = RACE_ROOMS;
+
+            DrawText(TextFormat("RACE %i/%i  OPPONENT %i/%i", rooms, RACE_ROOMS, opponentRooms, RACE_ROOMS), posX, posY, 10, RAYWHITE);
+            DrawText(TextFormat("rollback %i ticks max, %.2f ms", maxRollbackTicks, maxRollbackTime * 1000.0), posX, posY + 12, 10, GRAY);
+            if (status == RACE_FINISHED) DrawText(results[FindResult()], posX, posY + 28, 20, GOLD);
+        } break;
+    }
+}
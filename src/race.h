@@ -0,0 +1,62 @@
+/**********************************************************************************************
+*
+*   Race Mode
+*
+*   Two instances on the same machine race through the same rooms (the host's seed), the
+*   first to clear RACE_ROOMS rooms wins. Both instances simulate both players every tick
+*   without waiting for the network: the opponent's input is predicted by holding its last
+*   known one, the state before every tick is kept, and when the real input turns out
+*   different the state goes back to that tick and the ticks since are simulated again,
+*   within the same frame. Nobody runs more than RACE_MAX_ROLLBACK ticks past the inputs
+*   received from the other.
+*
+*   The first instance binds RACE_PORT and hosts, the second binds RACE_PORT + 1 and joins,
+*   both on 127.0.0.1. Packets are the raw structure, both ends must be the same build.
+*
+*   Runs on the main thread, in place of the simulation thread. Not available on
+*   PLATFORM_WEB and Windows, OpenRaceSession() returns false there.
+*
+**********************************************************************************************/
+
+#ifndef RACE_H
+#define RACE_H
+
+#define RACE_PORT 7777
+#define RACE_ROOMS 4                    // Rooms to clear, the room list repeats
+#define RACE_MAX_ROLLBACK 16            // Ticks simulated again at most in one frame
+
+typedef enum _RaceStatus {
+    RACE_WAITING = 0,                   // For the other instance
+    RACE_RUNNING,
+    RACE_FINISHED,                      // Winner confirmed by both inputs
+    RACE_DISCONNECTED
+} RaceStatus;
+
+typedef enum _RaceResult {
+    RACE_UNDECIDED = 0,
+    RACE_WON,
+    RACE_LOST,
+    RACE_DRAW                           // Both finished on the same tick
+} RaceResult;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Race Functions Declaration
+//----------------------------------------------------------------------------------
+bool OpenRaceSession(const GameState *state);   // Players start from state, reloaded with the host's seed
+void CloseRaceSession(void);                    // Logs the rollback stats
+void UpdateRace(void);                          // Once per frame after PollGameInput(), runs the due ticks
+RaceStatus GetRaceStatus(void);
+RaceResult GetRaceResult(void);
+const GameSnapshot *GetRaceSnapshot(void);      // Local player, like AcquireSnapshot()
+const GameState *GetRaceOpponent(void);         // Predicted, NULL until the race started
+void DrawRaceStatus(int posX, int posY);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RACE_H
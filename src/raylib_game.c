@@ -14,6 +14,18 @@
 
 #include "raylib.h"
 #include "screens.h"    // NOTE: Declares global (extern) variables and screens functions
+#include "memtrack.h"
+#include "audio.h"
+#include "gameplay.h"
+#include "pacing.h"
+#include "display.h"
+#include "telemetry.h"
+#include "hotreload.h"
+#include "logsink.h"
+#include "preload.h"
+#include "capture.h"
+#include "quality.h"
+#include "bench.h"
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -41,6 +53,11 @@ static bool transFadeOut = false;
 static int transFromScreen = -1;
 static int transToScreen = -1;
 
+// Owner tags for memory tracking, indexed by GameScreen
+static const char *screenNames[] = { "LOGO", "TITLE", "OPTIONS", "GAMEPLAY", "ENDING", "LEVELS" };
+static bool showDebugOverlay = false;
+static bool firstFrameShown = false;
+
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
@@ -49,40 +66,78 @@ static void ChangeToScreen(int screen);     // Change to screen, no transition e
 static void TransitionToScreen(int screen); // Request transition to next screen
 static void UpdateTransition(void);         // Update transition effect
 static void DrawTransition(void);           // Draw transition effect (full-screen rectangle)
+static void DrawDebugOverlay(void);         // Draw FPS, pacing, quality, memory totals and input latency (F3)
 
 static void UpdateDrawFrame(void);          // Update and draw one frame
 
+static void InitAudio(void);                // Audio device and thread, run by a preload worker
+static void FinishStartup(void);            // Collect what was loading behind the logo screen
+
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
     // Initialization
     //---------------------------------------------------------
-    SetConfigFlags(FLAG_MSAA_4X_HINT);
-    InitWindow(screenWidth, screenHeight, "raylib game template");
+    if (!ParseBenchmarkOptions(argc, argv)) return 1;     // --bench runs the render benchmark, see bench.h
 
-    InitAudioDevice();      // Initialize audio device
+    InitLogSink(LOG_INFO, LOGSINK_DEFAULT_RATE);   // First, so InitWindow() output goes through it too
+    InitPreload();          // Startup timeline starts here
 
-    // Load global data (assets that must be available in all screens, i.e. font)
-    font = LoadFont("resources/mecha.png");
+    // Pixel art is drawn into a fixed size display target and scaled up, no MSAA needed
+    BeginStartupPhase("window");
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(screenWidth, screenHeight, "raylib game template");
+    InitDisplay(screenWidth, screenHeight);
+    EndStartupPhase();
 
-    // Setup and init first screen
-    currentScreen = LOGO;
-    InitTitleScreen();
+    // Audio device and global data (assets that must be available in all screens, i.e. font)
+    // load behind the logo screen, together with the next screens' assets
+    PreloadTask("audio device", InitAudio);
+    PreloadImage("resources/mecha.png");
+    PreloadTitleScreen();
+    PreloadGameplayScreen();
+
+    if (IsBenchmarkRequested())
+    {
+        // Straight to gameplay, no logo screen to load behind. No telemetry or hot reload,
+        // scripted play is not play data and edited files would change the results
+        FinishStartup();
+        currentScreen = GAMEPLAY;
+        SetMemoryOwner(screenNames[GAMEPLAY]);
+        StartBenchmark();
+    }
+    else
+    {
+        InitTelemetry("telemetry");
+        InitHotReload("resources");     // HOT_RELOAD builds only, edits are picked up by the gameplay screen
+
+        // Setup and init first screen
+        currentScreen = LOGO;
+        SetMemoryOwner(screenNames[LOGO]);
+        BeginStartupPhase(screenNames[LOGO]);
+        InitLogoScreen();
+        EndStartupPhase();
+
+        SetFramePacing(PACING_VSYNC, 60);   // Cycle modes with F5, stats on the F3 overlay
+        InitQualityGovernor();              // Cycle fixed levels with F7
+    }
 
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
-    SetTargetFPS(60);       // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
 
     // Main game loop
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
-        UpdateDrawFrame();
+        if (!IsBenchmarkRequested()) UpdateDrawFrame();
+        else if (!UpdateBenchmarkFrame()) break;
     }
 #endif
+    int result = 0;
+    if (IsBenchmarkRequested() && !FinishBenchmark()) result = 1;
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
@@ -91,21 +146,37 @@ int main(void)
     {
         case LOGO: UnloadLogoScreen(); break;
         case TITLE: UnloadTitleScreen(); break;
+        case OPTIONS: UnloadOptionsScreen(); break;
         case GAMEPLAY: UnloadGameplayScreen(); break;
         case ENDING: UnloadEndingScreen(); break;
+        case LEVELS: UnloadLevelsScreen(); break;
         default: break;
     }
+    ClosePreload();         // A worker may still be opening the audio device
+    StopCapture();          // Needs the GL context
 
     // Unload global data loaded
-    UnloadFont(font);
+    UnloadFontTracked(font);
     UnloadSound(fxCoin);
+    UnloadDisplay();
+
+    TraceMemoryLeaks();     // Everything still tracked here was never unloaded
+    TraceFramePacingStats();
+    TraceStartupTimeline();
+    if (!IsBenchmarkRequested())
+    {
+        CloseTelemetry();   // After the gameplay screen stopped the simulation thread
+        CloseHotReload();
+    }
 
+    CloseAudioThread();
     CloseAudioDevice();     // Close audio context
 
     CloseWindow();          // Close window and OpenGL context
+    CloseLogSink();
     //--------------------------------------------------------------------------------------
 
-    return 0;
+    return result;
 }
 
 //----------------------------------------------------------------------------------
@@ -119,18 +190,23 @@ static void ChangeToScreen(int screen)
     {
         case LOGO: UnloadLogoScreen(); break;
         case TITLE: UnloadTitleScreen(); break;
+        case OPTIONS: UnloadOptionsScreen(); break;
         case GAMEPLAY: UnloadGameplayScreen(); break;
         case ENDING: UnloadEndingScreen(); break;
+        case LEVELS: UnloadLevelsScreen(); break;
         default: break;
     }
 
     // Init next screen
+    SetMemoryOwner(screenNames[screen]);
     switch (screen)
     {
         case LOGO: InitLogoScreen(); break;
         case TITLE: InitTitleScreen(); break;
+        case OPTIONS: InitOptionsScreen(); break;
         case GAMEPLAY: InitGameplayScreen(); break;
         case ENDING: InitEndingScreen(); break;
+        case LEVELS: InitLevelsScreen(); break;
         default: break;
     }
 
@@ -168,18 +244,24 @@ static void UpdateTransition(void)
                 case OPTIONS: UnloadOptionsScreen(); break;
                 case GAMEPLAY: UnloadGameplayScreen(); break;
                 case ENDING: UnloadEndingScreen(); break;
+                case LEVELS: UnloadLevelsScreen(); break;
                 default: break;
             }
 
             // Load next screen
+            SetMemoryOwner(screenNames[transToScreen]);
+            BeginStartupPhase(screenNames[transToScreen]);
             switch (transToScreen)
             {
                 case LOGO: InitLogoScreen(); break;
                 case TITLE: InitTitleScreen(); break;
+                case OPTIONS: InitOptionsScreen(); break;
                 case GAMEPLAY: InitGameplayScreen(); break;
                 case ENDING: InitEndingScreen(); break;
+                case LEVELS: InitLevelsScreen(); break;
                 default: break;
             }
+            EndStartupPhase();
 
             currentScreen = transToScreen;
 
@@ -205,15 +287,39 @@ static void UpdateTransition(void)
 // Draw transition effect (full-screen rectangle)
 static void DrawTransition(void)
 {
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
+    DrawRectangle(0, 0, GetDisplayWidth(), GetDisplayHeight(), Fade(BLACK, transAlpha));
+}
+
+// Draw FPS, pacing, quality, memory totals and input latency (F3, latency measurement on F4)
+static void DrawDebugOverlay(void)
+{
+    DrawRectangle(4, GetScreenHeight() - 140, 170, 136, Fade(BLACK, 0.6f));
+    DrawFPS(10, GetScreenHeight() - 134);
+    DrawFramePacingStats(10, GetScreenHeight() - 112);
+    DrawQualityStatus(10, GetScreenHeight() - 88);
+    DrawMemoryOverlay(10, GetScreenHeight() - 76);
+    DrawInputLatency(10, GetScreenHeight() - 16);
 }
 
 // Update and draw game frame
 static void UpdateDrawFrame(void)
 {
+    BeginFramePacing();
+
     // Update
     //----------------------------------------------------------------------------------
-    UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
+    UpdateAudioThread();            // NOTE: Music keeps playing between screens
+    UpdateTelemetry();
+
+    if (IsKeyPressed(KEY_F3)) showDebugOverlay = !showDebugOverlay;
+    if (IsKeyPressed(KEY_F4)) SetInputLatencyMode(!IsInputLatencyMode());
+    if (IsKeyPressed(KEY_F5)) SetFramePacing((GetFramePacingMode() + 1) % PACING_MODE_COUNT, GetFramePacingCap());
+    if (IsKeyPressed(KEY_F6))
+    {
+        if (IsCapturing()) StopCapture();
+        else StartCapture("captures");
+    }
+    if (IsKeyPressed(KEY_F7)) SetQualityLevel(IsQualityAutomatic() ? QUALITY_LEVELS - 1 : GetQualityLevel() - 1);   // Down to -1, automatic again
 
     if (!onTransition)
     {
@@ -223,7 +329,11 @@ static void UpdateDrawFrame(void)
             {
                 UpdateLogoScreen();
 
-                if (FinishLogoScreen()) TransitionToScreen(TITLE);
+                if (FinishLogoScreen())
+                {
+                    FinishStartup();
+                    TransitionToScreen(TITLE);
+                }
 
             } break;
             case TITLE:
@@ -232,6 +342,12 @@ static void UpdateDrawFrame(void)
 
                 if (FinishTitleScreen() == 1) TransitionToScreen(OPTIONS);
                 else if (FinishTitleScreen() == 2) TransitionToScreen(GAMEPLAY);
+                else if (FinishTitleScreen() == 3)
+                {
+                    SetGameplayRace(true);
+                    TransitionToScreen(GAMEPLAY);
+                }
+                else if (FinishTitleScreen() == 4) TransitionToScreen(LEVELS);
 
             } break;
             case OPTIONS:
@@ -240,6 +356,14 @@ static void UpdateDrawFrame(void)
 
                 if (FinishOptionsScreen()) TransitionToScreen(TITLE);
 
+            } break;
+            case LEVELS:
+            {
+                UpdateLevelsScreen();
+
+                if (FinishLevelsScreen() == 1) TransitionToScreen(TITLE);
+                else if (FinishLevelsScreen() == 2) TransitionToScreen(GAMEPLAY);
+
             } break;
             case GAMEPLAY:
             {
@@ -264,7 +388,7 @@ static void UpdateDrawFrame(void)
 
     // Draw
     //----------------------------------------------------------------------------------
-    BeginDrawing();
+    BeginDisplay();
 
         ClearBackground(RAYWHITE);
 
@@ -275,14 +399,46 @@ static void UpdateDrawFrame(void)
             case OPTIONS: DrawOptionsScreen(); break;
             case GAMEPLAY: DrawGameplayScreen(); break;
             case ENDING: DrawEndingScreen(); break;
+            case LEVELS: DrawLevelsScreen(); break;
             default: break;
         }
 
         // Draw full screen rectangle in front of everything
         if (onTransition) DrawTransition();
 
-        //DrawFPS(10, 10);
+    EndDisplay();
+    CaptureFrame(GetDisplayTarget());   // Recording with F6, the display resolution without overlays
+
+    // Window resolution from here on
+    if (showDebugOverlay) DrawDebugOverlay();
+    DrawCaptureStatus(GetScreenWidth() - 110, 8);
 
+    SubmitFramePacing();
     EndDrawing();
+    EndFramePacing();
+    UpdateQualityGovernor();
     //----------------------------------------------------------------------------------
+
+    if (!firstFrameShown) MarkStartup("first frame");
+    firstFrameShown = true;
+}
+
+// Audio device and thread, run by a preload worker while the logo screen shows
+static void InitAudio(void)
+{
+    InitAudioDevice();      // Initialize audio device
+    InitAudioThread(AUDIO_DEFAULT_BUFFER_FRAMES);  // Music streams refill off the main loop
+}
+
+// The title screen needs audio and the font, usually ready long before the logo ends
+static void FinishStartup(void)
+{
+    BeginStartupPhase("finish startup");
+    WaitPreloadTask("audio device");
+
+    SetMemoryOwner("GLOBAL");
+    Image fontImage = GetPreloadedImage("resources/mecha.png");
+    font = LoadFontFromImageTracked(fontImage, MAGENTA, 32);    // Same as LoadFont() for image fonts
+    UnloadImageTracked(fontImage);
+    EndStartupPhase();
 }
@@ -0,0 +1,24 @@
+#version 100
+
+precision mediump float;
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;     // Composed gameplay frame
+uniform vec4 colDiffuse;
+uniform sampler2D lightmap;     // Low resolution light values, one channel
+uniform float darkness;         // 0.0 full oxygen, 1.0 empty
+
+void main()
+{
+    vec4 texelColor = texture2D(texture0, fragTexCoord);
+
+    // Render texture is drawn flipped, the lightmap is not
+    float light = texture2D(lightmap, vec2(fragTexCoord.x, 1.0 - fragTexCoord.y)).r;
+    float vignette = 1.0 - darkness*smoothstep(0.2, 0.75, length(fragTexCoord - vec2(0.5)));
+
+    gl_FragColor = vec4(texelColor.rgb*light*vignette, texelColor.a)*colDiffuse*fragColor;
+}
@@ -0,0 +1,206 @@
+/**********************************************************************************************
+*
+*   Rewind Buffer Functions Definitions
+*
+*   Ring buffer holding one gameplay snapshot per tick. Room data is stored in keyframes,
+*   every tick only keeps the player plus the tiles that differ from its keyframe, so
+*   REWIND_FRAMES ticks of history stay well under 100 KB.
+*
+*   A new keyframe is written every REWIND_KEYFRAME_INTERVAL ticks, on room change or
+*   rotation, and whenever a tick would need more than REWIND_MAX_DELTAS tile changes.
+*   Restoring a tick is one keyframe copy plus at most REWIND_MAX_DELTAS writes.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+#include "gameplay.h"
+
+#define REWIND_FRAMES 720               // 12 seconds at 60 ticks per second
+#define REWIND_KEYFRAMES 128
+#define REWIND_KEYFRAME_INTERVAL 60
+#define REWIND_MAX_DELTAS 16
+
+#define ROOM_CELLS (ROOM_SIZE * ROOM_SIZE)
+#define BACKGROUND_CELLS (BACKGROUND_TILES * BACKGROUND_TILES)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _RewindKeyframe {
+    unsigned char tiles[ROOM_CELLS];
+    unsigned char background[BACKGROUND_CELLS];
+    Vector2 start;
+    int rotations;
+    int currentRoom;
+    int nextRoom;
+    unsigned int seed;
+} RewindKeyframe;
+
+typedef struct _TileDelta {
+    unsigned char cell;
+    unsigned char tile;
+} TileDelta;
+
+typedef struct _RewindTick {
+    Player player;
+    unsigned int keyframe;              // Keyframe sequence number, not slot
+    unsigned char deltaCount;
+    TileDelta deltas[REWIND_MAX_DELTAS];
+} RewindTick;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static RewindKeyframe keyframes[REWIND_KEYFRAMES] = { 0 };
+static RewindTick frames[REWIND_FRAMES] = { 0 };
+
+static unsigned int keyframeCount = 0;  // Keyframes written so far, newest is keyframeCount - 1
+static int ticksSinceKeyframe = 0;
+static int frameHead = 0;               // Next slot to write
+static int frameCount = 0;
+
+static RewindKeyframe respawnKeyframe = { 0 };
+static Player respawnPlayer = { 0 };
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void EncodeKeyframe(RewindKeyframe *key, const GameState *state)
+{
+    const TileType *tiles = &state->room.tiles[0][0];
+    const int *background = &state->room.background[0][0];
+
+    for (int i = 0; i < ROOM_CELLS; i++) key->tiles[i] = (unsigned char)tiles[i];
+    for (int i = 0; i < BACKGROUND_CELLS; i++) key->background[i] = (unsigned char)background[i];
+    key->start = state->room.start;
+    key->rotations = state->rotations;
+    key->currentRoom = state->currentRoom;
+    key->nextRoom = state->nextRoom;
+    key->seed = state->seed;
+}
+
+static void DecodeKeyframe(const RewindKeyframe *key, GameState *state)
+{
+    TileType *tiles = &state->room.tiles[0][0];
+    int *background = &state->room.background[0][0];
+
+    for (int i = 0; i < ROOM_CELLS; i++) tiles[i] = (TileType)key->tiles[i];
+    for (int i = 0; i < BACKGROUND_CELLS; i++) background[i] = key->background[i];
+    state->room.start = key->start;
+    state->rotations = key->rotations;
+    state->currentRoom = key->currentRoom;
+    state->nextRoom = key->nextRoom;
+    state->seed = key->seed;
+}
+
+// Room-wide values can't be expressed as tile deltas, any change forces a keyframe
+static bool KeyframeMatches(const RewindKeyframe *key, const GameState *state)
+{
+    if ((key->rotations != state->rotations) || (key->currentRoom != state->currentRoom)) return false;
+    if ((key->nextRoom != state->nextRoom) || (key->seed != state->seed)) return false;
+    if ((key->start.x != state->room.start.x) || (key->start.y != state->room.start.y)) return false;
+
+    const int *background = &state->room.background[0][0];
+    for (int i = 0; i < BACKGROUND_CELLS; i++) {
+        if (key->background[i] != background[i]) return false;
+    }
+    return true;
+}
+
+static void PushKeyframe(const GameState *state)
+{
+    EncodeKeyframe(&keyframes[keyframeCount % REWIND_KEYFRAMES], state);
+    keyframeCount++;
+    ticksSinceKeyframe = 0;
+
+    // Ticks pointing at the keyframe slot just overwritten can't be restored anymore
+    while (frameCount > 0) {
+        int oldest = (frameHead - frameCount + REWIND_FRAMES) % REWIND_FRAMES;
+        if (keyframeCount - frames[oldest].keyframe <= REWIND_KEYFRAMES) break;
+        frameCount--;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Rewind Buffer Functions Definition
+//----------------------------------------------------------------------------------
+void ResetRewindBuffer(void)
+{
+    keyframeCount = 0;
+    ticksSinceKeyframe = 0;
+    frameHead = 0;
+    frameCount = 0;
+}
+
+void RecordRewindFrame(const GameState *state)
+{
+    RewindTick *frame = &frames[frameHead];
+    const TileType *tiles = &state->room.tiles[0][0];
+    bool needKeyframe = (keyframeCount == 0) || (ticksSinceKeyframe >= REWIND_KEYFRAME_INTERVAL);
+
+    if (!needKeyframe) needKeyframe = !KeyframeMatches(&keyframes[(keyframeCount - 1) % REWIND_KEYFRAMES], state);
+
+    frame->deltaCount = 0;
+    if (!needKeyframe) {
+        const RewindKeyframe *key = &keyframes[(keyframeCount - 1) % REWIND_KEYFRAMES];
+        for (int i = 0; i < ROOM_CELLS; i++) {
+            if (key->tiles[i] == tiles[i]) continue;
+            if (frame->deltaCount == REWIND_MAX_DELTAS) {
+                needKeyframe = true;
+                break;
+            }
+            frame->deltas[frame->deltaCount++] = (TileDelta){ (unsigned char)i, (unsigned char)tiles[i] };
+        }
+    }
+    if (needKeyframe) {
+        frame->deltaCount = 0;
+        PushKeyframe(state);
+    }
+
+    frame->player = state->player;
+    frame->keyframe = keyframeCount - 1;
+    ticksSinceKeyframe++;
+
+    frameHead = (frameHead + 1) % REWIND_FRAMES;
+    if (frameCount < REWIND_FRAMES) frameCount++;
+}
+
+bool RewindFrame(GameState *state)
+{
+    // The newest tick is the current state, so at least two are needed to go back
+    if (frameCount < 2) return false;
+
+    frameHead = (frameHead - 1 + REWIND_FRAMES) % REWIND_FRAMES;
+    frameCount--;
+
+    const RewindTick *frame = &frames[(frameHead - 1 + REWIND_FRAMES) % REWIND_FRAMES];
+    DecodeKeyframe(&keyframes[frame->keyframe % REWIND_KEYFRAMES], state);
+    for (int i = 0; i < frame->deltaCount; i++) {
+        (&state->room.tiles[0][0])[frame->deltas[i].cell] = (TileType)frame->deltas[i].tile;
+    }
+    state->player = frame->player;
+
+    // Keyframes newer than this tick are dead, recording resumes with a fresh one
+    keyframeCount = frame->keyframe + 1;
+    ticksSinceKeyframe = REWIND_KEYFRAME_INTERVAL;
+
+    return true;
+}
+
+int GetRewindFrameCount(void)
+{
+    return frameCount;
+}
+
+void SetRespawnPoint(const GameState *state)
+{
+    EncodeKeyframe(&respawnKeyframe, state);
+    respawnPlayer = state->player;
+}
+
+void RestoreRespawnPoint(GameState *state)
+{
+    DecodeKeyframe(&respawnKeyframe, state);
+    state->player = respawnPlayer;
+}
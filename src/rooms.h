@@ -21,7 +21,7 @@ typedef struct _Tile {
     TileType type;
 } Tile;
 
-TileType room_tile[NUM_ROOMS][ROOM_SIZE][ROOM_SIZE] = {{1, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+static const TileType room_tile[NUM_ROOMS][ROOM_SIZE][ROOM_SIZE] = {{1, 2, 2, 1, 1, 1, 1, 1, 1, 1,
                                                         1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
                                                         1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
                                                         1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
@@ -25,6 +25,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "display.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -42,6 +43,7 @@ void InitEndingScreen(void)
     // TODO: Initialize ENDING screen variables here!
     framesCounter = 0;
     finishScreen = 0;
+    PreloadTitleScreen();       // Only leads back to the title
 }
 
 // Ending Screen Update logic
@@ -61,7 +63,7 @@ void UpdateEndingScreen(void)
 void DrawEndingScreen(void)
 {
     // TODO: Draw ENDING screen here!
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
+    DrawRectangle(0, 0, GetDisplayWidth(), GetDisplayHeight(), BLUE);
     DrawTextEx(font, "ENDING SCREEN", (Vector2){ 20, 10 }, font.baseSize*3, 4, DARKBLUE);
     DrawText("PRESS ENTER or TAP to RETURN to TITLE SCREEN", 60, 220, 20, DARKBLUE);
 }
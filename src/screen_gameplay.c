@@ -23,7 +23,13 @@
 **********************************************************************************************/
 #include "raylib.h"
 #include "screens.h"
-#include "rooms.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include "audio.h"
+#include "hotreload.h"
+#include "preload.h"
+#include "race.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
@@ -35,34 +41,15 @@
 //----------------------------------------------------------------------------------
 static int framesCounter = 0;
 static int finishScreen = 0;
-static double groundedTime = 0.0f;
-static int rotations = 0;
-static int next_room = 0;
-
-void LoadRoom(int room_num);
-
-#define MAX_OXYGEN 100
-#define BACKGROUND_SIZE 64
-
-
-typedef struct _Room {
-    TileType tiles[ROOM_SIZE][ROOM_SIZE];
-    Vector2 start;
-    int background[ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE][ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE];
-} Room;
-
-typedef enum _PlayerState {
-    IDLE,
-    FALL,
-    WALKING,
-    GROUNDED,
-    ROTATING
-} PlayerState;
-
-typedef enum _PlayerDirection {
-    RIGHT = 1,
-    LEFT = -1
-} PlayerDirection;
+static GameState game = { 0 };                 // Setup state, the live one is on the simulation thread
+static const GameSnapshot *view = NULL;         // What is drawn this frame
+static unsigned int viewTick = 0;
+static unsigned int viewRewindTicks = 0;
+static unsigned int seenEvents[GAME_EVENT_KINDS] = { 0 };
+static bool raceMode = false;                   // Both players on this thread, see race.h
+static bool backgroundDetail = true;
+static int startRoom = -1;                      // Picked on the level select screen
+static bool benchmarkMode = false;              // Same background on every run, see bench.h
 
 typedef struct _PlayerSheets {
     Texture2D idle;
@@ -72,19 +59,18 @@ typedef struct _PlayerSheets {
 } PlayerSheets;
 
 
-typedef struct _Player {
-    Vector2 position;
-    Vector2 velocity;
-    PlayerState state;
-    PlayerDirection direction;
-    int width;
-    int height;
-    float oxygen;
-} Player;
-
 PlayerSheets playerSprite;
-Player player;
-Room room;
+
+// Player clips indexed by PlayerState
+static AnimationClip playerClips[] = {
+    [IDLE] = { &playerSprite.idle, 5, 8.0f / 60.0f, ANIMATION_LOOP },
+    [FALL] = { &playerSprite.fall, 4, 10.0f / 60.0f, ANIMATION_LOOP },
+    [WALKING] = { &playerSprite.horizontal, 8, 5.0f / 60.0f, ANIMATION_LOOP },
+    [GROUNDED] = { &playerSprite.grounded, 4, GETUP_TIME / 4, ANIMATION_ONCE },
+    [ROTATING] = { &playerSprite.idle, 5, 0.0f, ANIMATION_ONCE },
+};
+static Animator playerAnimator = { 0 };
+static Animator opponentAnimator = { 0 };
 Tile ground;
 Tile stalagmite;
 Tile stalactite;
@@ -99,292 +85,290 @@ Sound groundedSound;
 Sound rotatingSound;
 Sound fallingSound;
 Sound deathSound;
+Sound lowAirSound;
+
+typedef struct _TextureFile {
+    const char *fileName;
+    Texture2D *texture;
+} TextureFile;
+
+typedef struct _SoundFile {
+    const char *fileName;
+    Sound *sound;
+} SoundFile;
+
+// Assets decoded ahead by PreloadGameplayScreen(), and reloaded in place when their file changes
+static const TextureFile textureFiles[] = {
+    { "resources/art/Miner_Idle-Sheet.png", &playerSprite.idle },
+    { "resources/art/Miner_Walk-Sheet.png", &playerSprite.horizontal },
+    { "resources/art/Miner_Fall-Sheet.png", &playerSprite.fall },
+    { "resources/art/Miner_Getup-Sheet.png", &playerSprite.grounded },
+    { "resources/art/Ground_Tiles-Sheet.png", &ground.texture },
+    { "resources/art/Stalagmite_Rotate-Sheet.png", &stalagmite.texture },
+    { "resources/art/Stalactite_Rotate-Sheet.png", &stalactite.texture },
+    { "resources/art/Oxygen_Bar-Sheet.png", &oxygen_bar },
+    { "resources/art/Backgrounds-Sheet.png", &background },
+};
+static const SoundFile soundFiles[] = {
+    { "resources/music/GroundedSound.wav", &groundedSound },
+    { "resources/music/RotatingSound.wav", &rotatingSound },
+    { "resources/music/DeathSound.wav", &deathSound },
+    { "resources/music/fallingSound.wav", &fallingSound },
+    { "resources/music/LowAirSound.wav", &lowAirSound },
+};
 
 //----------------------------------------------------------------------------------
-// Gameplay Screen Functions Definition
+// Local Functions Definition
 //----------------------------------------------------------------------------------
+#if defined(HOT_RELOAD)
+static const char *GetRoomFileName(int room)
+{
+    return TextFormat("resources/rooms/room_%02i.txt", room);
+}
+#endif
 
-// Gameplay Screen Initialization logic
-void InitGameplayScreen(void)
+// Room files override the rooms built into rooms.h, only in hot reload builds
+void LoadRoomFiles(void)
 {
-    Image sprite_sheet_images[4] = {LoadImage("resources/art/Miner_Idle-Sheet.png"),
-                                    LoadImage("resources/art/Miner_Walk-Sheet.png"),
-                                    LoadImage("resources/art/Miner_Fall-Sheet.png"),
-                                    LoadImage("resources/art/Miner_Getup-Sheet.png")};
-    Image tile_texture_images[3] = {LoadImage("resources/art/Ground_Tiles-Sheet.png"),
-                                    LoadImage("resources/art/Stalagmite_Rotate-Sheet.png"),
-                                    LoadImage("resources/art/Stalactite_Rotate-Sheet.png")};
-
-    Image oxygen_bar_image = LoadImage("resources/art/Oxygen_Bar-Sheet.png");
-    Image background_image = LoadImage("resources/art/Backgrounds-Sheet.png");
-    for (int i = 0; i < 4; i++) {
-        ImageResize(&(sprite_sheet_images[i]), sprite_sheet_images[i].width * SCALAR, sprite_sheet_images[i].height * SCALAR);
-    }
-    for (int i = 0; i < 3; i++) {
-        ImageResize(&(tile_texture_images[i]), tile_texture_images[i].width * SCALAR, tile_texture_images[i].height * SCALAR);
+#if defined(HOT_RELOAD)
+    for (int r = 0; r < NUM_ROOMS; r++) {
+        if (FileExists(GetRoomFileName(r)) && !LoadRoomFile(r, GetRoomFileName(r))) {
+            TraceLog(LOG_WARNING, "ROOM: [%s] Invalid room file, using the built-in room", GetRoomFileName(r));
+        }
     }
+#endif
+}
 
-    playerSprite = (PlayerSheets){.idle = LoadTextureFromImage(sprite_sheet_images[0]),
-                                  .horizontal = LoadTextureFromImage(sprite_sheet_images[1]),
-                                  .fall = LoadTextureFromImage(sprite_sheet_images[2]),
-                                  .grounded = LoadTextureFromImage(sprite_sheet_images[3])};
-    ground = (Tile){.texture = LoadTextureFromImage(tile_texture_images[0]), .type = GROUND};
-    stalagmite = (Tile){.texture = LoadTextureFromImage(tile_texture_images[1]), .type = STALAGMITE};
-    stalactite = (Tile){.texture = LoadTextureFromImage(tile_texture_images[2]), .type = STALACTITE};
-    player = (Player) {(Vector2){.x = 0, .y = 0}, (Vector2){0.0f, 0.0f}, IDLE, RIGHT, 16 * SCALAR, 16 * SCALAR, MAX_OXYGEN};
-    oxygen_bar = LoadTextureFromImage(oxygen_bar_image);
-    background = LoadTextureFromImage(background_image);
-    LoadRoom(next_room);
-    framesCounter = 0;
-    finishScreen = 0;
-    SetTargetFPS(60);
-    for (int i = 0; i < 4; i++) {
-        UnloadImage(sprite_sheet_images[i]);
+// Simulation paused while a room changes, the current room keeps rotation and player
+static void ReloadRoom(int room, const char *fileName)
+{
+    StopSimulationThread();
+    game = AcquireSnapshot()->state;
+
+    if (!LoadRoomFile(room, fileName)) {
+        TraceLog(LOG_WARNING, "HOTRELOAD: [%s] Expected %i tiles between %i and %i, room %i not changed", fileName, ROOM_SIZE * ROOM_SIZE, AIR, RAIL, room);
     }
-    for (int i = 0; i < 3; i++) {
-        UnloadImage(tile_texture_images[i]);
+    else {
+        if (room == game.currentRoom) {
+            GameState respawn = game;
+
+            ReloadRoomTiles(&game);
+            RestoreRespawnPoint(&respawn);
+            ReloadRoomTiles(&respawn);
+            SetRespawnPoint(&respawn);
+            ResetRewindBuffer();    // Older ticks would bring the old tiles back
+        }
+        TraceLog(LOG_INFO, "HOTRELOAD: [%s] Room %i reloaded", fileName, room);
     }
-    srand(time(NULL));
-    GameMusic = LoadMusicStream("resources/music/Gameplay-Music.wav");
-    PlayMusicStream(GameMusic);
 
-    groundedSound = LoadSound("resources/music/GroundedSound.wav");
-    rotatingSound = LoadSound("resources/music/RotatingSound.wav");
-    deathSound = LoadSound("resources/music/DeathSound.wav");
-    fallingSound = LoadSound("resources/music/fallingSound.wav");
-
-    SetSoundVolume(groundedSound, 0.4);
-    SetSoundVolume(rotatingSound, 0.4);
-    SetSoundVolume(deathSound, 0.4);
-    SetSoundVolume(fallingSound, 0.4);
-
-    SetMusicVolume(GameMusic, 0.30);
+    StartSimulationThread(&game);
+    view = AcquireSnapshot();
+    viewTick = view->tick;          // The simulation thread counts from zero again
+    viewRewindTicks = view->rewindTicks;
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) seenEvents[k] = view->eventCounts[k];
+    UpdateTileCache(&view->state.room, view->state.rotations);
+    UpdateLighting(&view->state);
 }
 
-bool IsSolid(TileType tile) {
-    bool result = false;
-    switch (tile) {
-        case GROUND:
-            result = true;
-            break;
-        default:
-            break;
-    }
-    return result;
-}
+static void ReloadGameplayFile(const char *fileName)
+{
+    int room = 0;
 
-bool IsDeath(TileType tile) {
-    bool result = false;
-    switch (tile) {
-        case STALAGMITE:
-            result = true;
-            break;
-        case STALACTITE:
-            result = true;
-            break;
-        default:
-            break;
+    if (sscanf(fileName, "resources/rooms/room_%d.txt", &room) == 1) {
+        // The other instance would keep the old tiles
+        if (raceMode) TraceLog(LOG_WARNING, "HOTRELOAD: [%s] Rooms are not reloaded during a race", fileName);
+        else ReloadRoom(room, fileName);
+        return;
     }
-    return result;
-}
 
-void PlayerDeath() {
-    LoadRoom(next_room - 1);
-}
-bool CheckCollisionY(void) {
-    int left_tile = player.position.x / TILE_SIZE;
-    int right_tile = (player.position.x / TILE_SIZE) + 1;
-    int bottom_tile = (player.position.y / TILE_SIZE)+ 1;
-
-    if(left_tile < 0) left_tile = 0;
-    if(right_tile > ROOM_SIZE) right_tile = ROOM_SIZE;
-    if(bottom_tile > ROOM_SIZE) bottom_tile = ROOM_SIZE;
-
-    bool any_collision = false;
-    if (room.tiles[bottom_tile][left_tile] == EXIT || room.tiles[bottom_tile][right_tile] == EXIT) {
-        LoadRoom(next_room);
-        return false;
-    }
-    if (IsDeath(room.tiles[bottom_tile][left_tile]) || IsDeath(room.tiles[bottom_tile][right_tile])) {
-        if (!IsSoundPlaying(deathSound)) {
-            PlaySound(deathSound);
+    for (int i = 0; i < (int)(sizeof(textureFiles) / sizeof(textureFiles[0])); i++) {
+        if ((strcmp(fileName, textureFiles[i].fileName) == 0) && ReloadTexture(textureFiles[i].texture, fileName)) {
+            // Sheet sizes may have changed
+            for (int c = 0; c < (int)(sizeof(playerClips) / sizeof(playerClips[0])); c++) InitAnimationClip(&playerClips[c]);
+            ResetTileCache();
+            UpdateTileCache(&view->state.room, view->state.rotations);
         }
-        PlayerDeath();
-        return false;
     }
-    for(int j = left_tile; j <= right_tile; j++)
-    {
-        TileType t = room.tiles[bottom_tile][j];
-        if (IsSolid(t) && ((player.position.x < j * TILE_SIZE) || ((player.position.x + player.width) > j * TILE_SIZE))) {
-            any_collision = true;
-            if ((player.position.y + player.height) > (bottom_tile * TILE_SIZE)) {
-                if (!IsSoundPlaying(groundedSound)) {
-                    PlaySound(groundedSound);
-                }
-                player.state = GROUNDED;
-                groundedTime = GetTime();
-                player.velocity.y = 0.0f;
-                player.position.y = (bottom_tile - 1) * TILE_SIZE;
-            }
-        }
-    }
-    if (!any_collision) {
-        if (!IsSoundPlaying(fallingSound)) {
-            PlaySound(fallingSound);
+
+    for (int i = 0; i < (int)(sizeof(soundFiles) / sizeof(soundFiles[0])); i++) {
+        if ((strcmp(fileName, soundFiles[i].fileName) == 0) && ReloadSound(soundFiles[i].sound, fileName)) {
+            SetSoundVolume(*soundFiles[i].sound, 0.4);
         }
-        player.state = FALL;
     }
-    return any_collision;
 }
 
-bool CheckCollisionX(void) {
-    int left_tile = player.position.x / TILE_SIZE;
-    int right_tile = (player.position.x / TILE_SIZE) + 1;
-    int top_tile = player.position.y / TILE_SIZE;
-
-    if(left_tile < 0) left_tile = 0;
-    if(right_tile > ROOM_SIZE) right_tile = ROOM_SIZE;
-    if(top_tile < 0) top_tile = 0;
+//----------------------------------------------------------------------------------
+// Gameplay Screen Functions Definition
+//----------------------------------------------------------------------------------
 
-    bool any_collision = false;
-    if (room.tiles[top_tile][right_tile] == EXIT) {
-        LoadRoom(next_room);
-        return false;
-    }
-    if (IsDeath(room.tiles[top_tile][right_tile])) {
-        PlayerDeath();
-        return false;
-    }
-    for(int j = left_tile; j <= right_tile; j++)
-    {
-        TileType t = room.tiles[top_tile][j];
-        if (IsSolid(t)) {
-            if (player.state == ROTATING) {
-                player.velocity.x = (j == left_tile) ? 0.1f : -0.1f;
-            }
-            any_collision = true;
-        }
-    }
-    return any_collision;
+// Gameplay Screen assets decoded ahead, queued by the title screen
+void PreloadGameplayScreen(void)
+{
+    for (int i = 0; i < (int)(sizeof(textureFiles) / sizeof(textureFiles[0])); i++) PreloadImage(textureFiles[i].fileName);
+    for (int i = 0; i < (int)(sizeof(soundFiles) / sizeof(soundFiles[0])); i++) PreloadWave(soundFiles[i].fileName);
 }
 
-void RotateRoom(void) {
-    if (!IsSoundPlaying(rotatingSound)) {
-        PlaySound(rotatingSound);
-    }
-    Vector2 oldposition = player.position;
-    float cosine = cos(90.0 * PI / 180.0);
-    float sine = sin(90.0 * PI / 180.0);
-
-    for (int i = 0; i < (ROOM_SIZE + 1) / 2; i ++) {
-        for (int j = 0; j < ROOM_SIZE / 2; j++) {
-            TileType temp = room.tiles[ROOM_SIZE - 1 - j][i];
-            room.tiles[ROOM_SIZE - 1 - j][i] = room.tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1];
-            room.tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1] = room.tiles[j][ROOM_SIZE - 1 -i];
-            room.tiles[j][ROOM_SIZE - 1 - i] = room.tiles[i][j];
-            room.tiles[i][j] = temp;
-        }
-    }
-
-    Vector2 center = (Vector2){.x = (float)(ROOM_SIZE / 2) * TILE_SIZE, .y = (float)(ROOM_SIZE / 2) * TILE_SIZE};
+// Two players over local UDP instead of the simulation thread
+void SetGameplayRace(bool race)
+{
+    raceMode = race;
+}
 
-    player.position.x = (oldposition.x - center.x) * cosine - (oldposition.y - center.y) * sine + (center.x);
-    player.position.y = (oldposition.x - center.x) * sine + (oldposition.y - center.y) * cosine + (center.y);
-    
-    rotations++;
-    if (rotations > 3) {
-        rotations = 0;
-    }
+void SetGameplayRoom(int room)
+{
+    startRoom = room;
+}
 
+void SetGameplayBenchmark(bool benchmark)
+{
+    benchmarkMode = benchmark;
+}
 
+// Lowered by the quality governor
+void SetGameplayBackgroundDetail(bool detailed)
+{
+    backgroundDetail = detailed;
 }
 
-void LoadRoom(int room_num) {
-    if (room_num < 0) room_num = 0;
-    if (room_num >= NUM_ROOMS) room_num = (NUM_ROOMS - 1);
-    for (int i = 0; i < ROOM_SIZE; i++) {
-            for (int j = 0; j < ROOM_SIZE; j++) {
-                room.tiles[i][j] = room_tile[room_num][i][j];
-                if (room.tiles[i][j] == START) {
-                    room.start.x = j;
-                    room.start.y = i;
-                }
-            }
+// Gameplay Screen Initialization logic
+void InitGameplayScreen(void)
+{
+    Image sprite_sheet_images[4] = {GetPreloadedImage("resources/art/Miner_Idle-Sheet.png"),
+                                    GetPreloadedImage("resources/art/Miner_Walk-Sheet.png"),
+                                    GetPreloadedImage("resources/art/Miner_Fall-Sheet.png"),
+                                    GetPreloadedImage("resources/art/Miner_Getup-Sheet.png")};
+    Image tile_texture_images[3] = {GetPreloadedImage("resources/art/Ground_Tiles-Sheet.png"),
+                                    GetPreloadedImage("resources/art/Stalagmite_Rotate-Sheet.png"),
+                                    GetPreloadedImage("resources/art/Stalactite_Rotate-Sheet.png")};
+
+    Image oxygen_bar_image = GetPreloadedImage("resources/art/Oxygen_Bar-Sheet.png");
+    Image background_image = GetPreloadedImage("resources/art/Backgrounds-Sheet.png");
+    // Sprite and tile sheets stay at art size, they are scaled by SCALAR when drawn
+
+    playerSprite = (PlayerSheets){.idle = LoadTextureFromImageTracked(sprite_sheet_images[0]),
+                                  .horizontal = LoadTextureFromImageTracked(sprite_sheet_images[1]),
+                                  .fall = LoadTextureFromImageTracked(sprite_sheet_images[2]),
+                                  .grounded = LoadTextureFromImageTracked(sprite_sheet_images[3])};
+    ground = (Tile){.texture = LoadTextureFromImageTracked(tile_texture_images[0]), .type = GROUND};
+    stalagmite = (Tile){.texture = LoadTextureFromImageTracked(tile_texture_images[1]), .type = STALAGMITE};
+    stalactite = (Tile){.texture = LoadTextureFromImageTracked(tile_texture_images[2]), .type = STALACTITE};
+    for (int i = 0; i < (int)(sizeof(playerClips) / sizeof(playerClips[0])); i++) InitAnimationClip(&playerClips[i]);
+    SetTileSheets(&ground.texture, &stalagmite.texture, &stalactite.texture);
+    InitLighting();
+    ClearParticles();
+    game.player = GetDefaultPlayer();
+    oxygen_bar = LoadTextureFromImageTracked(oxygen_bar_image);
+    background = LoadTextureFromImageTracked(background_image);
+    UnloadImageTracked(oxygen_bar_image);
+    UnloadImageTracked(background_image);
+    game.seed = benchmarkMode ? 1 : (unsigned int)time(NULL);
+    while (GetReloadedFile() != NULL) { }      // Everything is loaded fresh below
+    if (!benchmarkMode) LoadRoomFiles();
+    ResetRewindBuffer();
+    if (startRoom >= 0) {
+        game.nextRoom = startRoom;
+        game.rotations = 0;
+        startRoom = -1;
     }
-    for (int r = 0; r < rotations; r++) {
-        for (int i = 0; i < (ROOM_SIZE + 1) / 2; i ++) {
-                for (int j = 0; j < ROOM_SIZE / 2; j++) {
-                    TileType temp = room.tiles[ROOM_SIZE - 1 - j][i];
-                    room.tiles[ROOM_SIZE - 1 - j][i] = room.tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1];
-                    room.tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1] = room.tiles[j][ROOM_SIZE - 1 -i];
-                    room.tiles[j][ROOM_SIZE - 1 - i] = room.tiles[i][j];
-                    room.tiles[i][j] = temp;
-                    if (room.tiles[i][j] == START) {
-                        room.start.x = j;
-                        room.start.y = i;
-                    }
-                }
-        }
+    LoadRoom(&game, game.nextRoom);
+    SetRespawnPoint(&game);
+
+    ClearGameInput();
+    if (raceMode && !OpenRaceSession(&game)) raceMode = false;
+    if (raceMode) view = GetRaceSnapshot();
+    else {
+        StartSimulationThread(&game);
+        view = AcquireSnapshot();
     }
+    viewTick = view->tick;
+    viewRewindTicks = view->rewindTicks;
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) seenEvents[k] = view->eventCounts[k];
 
-    for (int i = 0; i < (ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE); i++) {
-        for (int j = 0; j < (ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE); j++) {
-            room.background[i][j] = GetRandomValue(1, 10);
-        }
+    PlayAnimation(&playerAnimator, &playerClips[view->state.player.state]);
+    UpdateTileCache(&view->state.room, view->state.rotations);
+    UpdateLighting(&view->state);
+    framesCounter = 0;
+    finishScreen = 0;
+    for (int i = 0; i < 4; i++) {
+        UnloadImageTracked(sprite_sheet_images[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        UnloadImageTracked(tile_texture_images[i]);
     }
+    GameMusic = LoadMusicStreamTracked("resources/music/Gameplay-Music.wav");
+    CrossfadeMusicAsync(GameMusic, 0.30f, 1.0f);
 
-    player.position.x = room.start.x * TILE_SIZE;
-    player.position.y = room.start.y * TILE_SIZE;
-    player.oxygen = MAX_OXYGEN;
-    next_room++;
-    if (next_room >= NUM_ROOMS) next_room = 0;
-}
+    groundedSound = GetPreloadedSound("resources/music/GroundedSound.wav");
+    rotatingSound = GetPreloadedSound("resources/music/RotatingSound.wav");
+    deathSound = GetPreloadedSound("resources/music/DeathSound.wav");
+    fallingSound = GetPreloadedSound("resources/music/fallingSound.wav");
+    lowAirSound = GetPreloadedSound("resources/music/LowAirSound.wav");
 
+    SetSoundVolume(groundedSound, 0.4);
+    SetSoundVolume(rotatingSound, 0.4);
+    SetSoundVolume(deathSound, 0.4);
+    SetSoundVolume(fallingSound, 0.4);
+    SetSoundVolume(lowAirSound, 0.4);
+}
 
 // Gameplay Screen Update logic
 void UpdateGameplayScreen(void)
 {
-    if (!IsMusicStreamPlaying(GameMusic)) {
-        PlayMusicStream(GameMusic);
-    }
-    UpdateMusicStream(GameMusic);
-    player.position.x += player.velocity.x;
-    if (CheckCollisionX()) {
-        player.position.x -= player.velocity.x;
-    }
+    const char *reloaded = NULL;
+    while ((reloaded = GetReloadedFile()) != NULL) ReloadGameplayFile(reloaded);
+
+    // Input goes to the simulation thread, everything below only reads its snapshots
+    PollGameInput();
+    if (raceMode) UpdateRace();
+    else UpdateSimulationThread();
 
-    player.position.y += player.velocity.y;
-    if (CheckCollisionY()) {
-        player.position.y -= player.velocity.y;
-    }
     // Press enter or tap to change to ENDING screen
     if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
     {
         finishScreen = 1;
         PlaySound(fxCoin);
     }
-    if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) {
-        if (player.state == IDLE) player.state = WALKING;
-        player.direction = LEFT;
-        player.velocity.x = -2.0f;
-    } else if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) {
-        if (player.state == IDLE) player.state = WALKING;
-        player.direction = RIGHT;
-        player.velocity.x = 2.0f;
-    } else {
-        if (player.state == WALKING) player.state = IDLE;
-        player.velocity.x = 0.0f;
-    }
 
-    if (player.state == FALL) player.velocity.y += 9.8f * GetFrameTime();
-    
-    if (IsKeyPressed(KEY_R)) {
-        RotateRoom();
+    const GameSnapshot *snapshot = raceMode ? GetRaceSnapshot() : AcquireSnapshot();
+    bool ticked = (snapshot->tick != viewTick);
+    int events = EVENT_NONE;
+
+    // Every tick since the last frame, even the ones whose snapshot was never drawn
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) {
+        if (snapshot->eventCounts[k] != seenEvents[k]) events |= (1 << k);
+        seenEvents[k] = snapshot->eventCounts[k];
+    }
+    // Clips play on simulation time: still while paused, not forward while rewinding
+    float animationTime = (int)((snapshot->tick - viewTick) - (snapshot->rewindTicks - viewRewindTicks)) * SIM_TICK_TIME;
+
+    view = snapshot;
+    UpdateInputLatency(snapshot->inputLatency);
+    viewTick = snapshot->tick;
+    viewRewindTicks = snapshot->rewindTicks;
+
+    if ((events & EVENT_GROUNDED) && !IsSoundPlaying(groundedSound)) PlaySound(groundedSound);
+    if ((events & EVENT_FALLING) && !IsSoundPlaying(fallingSound)) PlaySound(fallingSound);
+    if ((events & EVENT_ROTATED) && !IsSoundPlaying(rotatingSound)) PlaySound(rotatingSound);
+    if ((events & EVENT_DEATH_HAZARD) && !IsSoundPlaying(deathSound)) PlaySound(deathSound);
+    if (events & EVENT_OXYGEN_LOW) PlaySound(lowAirSound);
+
+    // The player is already back at the respawn point, the burst goes where they died
+    EmitGameParticles(&view->state, events, GetFrameTime());
+    if (events & EVENT_DEATH) {
+        EmitParticles(PARTICLES_DEATH, (Rectangle){ view->deathPosition.x, view->deathPosition.y,
+                      (float)view->state.player.width, (float)view->state.player.height }, 0);
     }
 
-    player.oxygen = player.oxygen - GetFrameTime() * 10;
-    if (player.oxygen <= 0) {
-        PlayerDeath();
+    PlayAnimation(&playerAnimator, &playerClips[view->state.player.state]);
+    UpdateAnimation(&playerAnimator, animationTime);
+    if (raceMode && (GetRaceOpponent() != NULL)) {
+        PlayAnimation(&opponentAnimator, &playerClips[GetRaceOpponent()->player.state]);
+        UpdateAnimation(&opponentAnimator, animationTime);
+    }
+    UpdateParticles(GetFrameTime());
+    if (ticked) {
+        UpdateTileCache(&view->state.room, view->state.rotations);
+        UpdateLighting(&view->state);
     }
 }
 
@@ -392,99 +376,74 @@ void UpdateGameplayScreen(void)
 void DrawGameplayScreen(void)
 {
     ClearBackground(BLACK);
-    for (int i = 0; i < (ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE); i++) {
-        for (int j = 0; j < (ROOM_SIZE * TILE_SIZE / BACKGROUND_SIZE); j++) {
-            DrawTextureRec(background, 
-                            (Rectangle){(float)(BACKGROUND_SIZE) * (room.background[i][j]),
-                            0.0f, (float)(BACKGROUND_SIZE), 
-                            (float)(BACKGROUND_SIZE)}, (Vector2){.x = j * BACKGROUND_SIZE, .y = i * BACKGROUND_SIZE}, WHITE);
+    BeginLighting();
+    if (backgroundDetail) {
+        for (int i = 0; i < BACKGROUND_TILES; i++) {
+            for (int j = 0; j < BACKGROUND_TILES; j++) {
+                DrawTextureRec(background, 
+                                (Rectangle){(float)(BACKGROUND_SIZE) * (view->state.room.background[i][j]),
+                                0.0f, (float)(BACKGROUND_SIZE), 
+                                (float)(BACKGROUND_SIZE)}, (Vector2){.x = j * BACKGROUND_SIZE, .y = i * BACKGROUND_SIZE}, WHITE);
+            }
         }
     }
                             
              
-    static int frame = 0;
-    if (frame >= 40 && player.state != GROUNDED) frame = 0;
-
     // DrawFPS(GetScreenWidth() - 90, GetScreenHeight() - 30);
-    // TODO: Draw GAMEPLAY screen here!
-    switch (player.state) {
-        case IDLE:
-            DrawTextureRec(playerSprite.idle, 
-                (Rectangle){(float)(playerSprite.idle.width / 5) * (frame / 8),
-                0.0f, player.direction * (float)(playerSprite.idle.width / 5), 
-                (float)(playerSprite.idle.height)}, player.position, WHITE);
-            break;
-        case WALKING:
-            DrawTextureRec(playerSprite.horizontal, 
-                (Rectangle){(float)(playerSprite.horizontal.width / 8) * (frame / 5),
-                0.0f, player.direction * (float)(playerSprite.horizontal.width / 8), 
-                (float)(playerSprite.horizontal.height)}, player.position, WHITE);
-            break;
-        case FALL:
-            DrawTextureRec(playerSprite.fall, 
-                (Rectangle){(float)(playerSprite.fall.width / 4) * (frame / 10),
-                0.0f, player.direction * (float)(playerSprite.fall.width / 4), 
-                (float)(playerSprite.fall.height)}, player.position, WHITE);
-            break;
-        case GROUNDED:
-            if (frame >= 4) frame = 0;
-            DrawTextureRec(playerSprite.grounded, 
-                (Rectangle){(float)(playerSprite.grounded.width / 4) * frame,
-                0.0f, player.direction * (float)(playerSprite.grounded.width / 4), 
-                (float)(playerSprite.grounded.height)}, player.position, WHITE);
-            if (GetTime() - groundedTime >= 0.25 || frame == 0) {
-                groundedTime = GetTime();
-                frame++;
-            }
-            if (frame > 3) {
-                frame = 0;
-                player.state = IDLE;
-            }
-            break;
-        case ROTATING:
-            DrawTextureRec(playerSprite.idle, 
-                (Rectangle){0.0f,
-                0.0f, player.direction * (float)(playerSprite.idle.width / 5), 
-                (float)(playerSprite.idle.height)}, player.position, WHITE);
-            break;
-    }
-    if (player.state != GROUNDED) frame++;
-    for (int i = 0; i < ROOM_SIZE; i++) {
-        for (int j = 0; j < ROOM_SIZE; j++) {
-            switch (room.tiles[i][j]) {
-                case GROUND:
-                    DrawTextureRec(ground.texture, 
-                        (Rectangle){(float)(ground.texture.width / 15) * (i + j),
-                        0.0f, (float)(ground.texture.width / 15), (float)(ground.texture.height)},
-                        (Vector2){.x = j * TILE_SIZE, .y = i * TILE_SIZE}, WHITE);
-                     break;
-                case STALAGMITE:
-                    DrawTextureRec(stalagmite.texture,
-                            (Rectangle){(float)(stalagmite.texture.width / 16) * ((i + j) % 4) + rotations * (stalagmite.texture.width / 4),
-                            0.0f, (float)(stalagmite.texture.width / 16), (float)(stalagmite.texture.height)},
-                            (Vector2){.x = j * TILE_SIZE, .y = i * TILE_SIZE}, WHITE);
-                    /* DrawTexturePro(stalagmite.texture, (Rectangle){(float)(stalagmite.texture.width / 4) * ((i + j) % 4), 0.0f,
-                            (float)(stalagmite.texture.width / 4), (float)(stalagmite.texture.height)}, (Rectangle){j * TILE_SIZE,
-                            i * TILE_SIZE, stalagmite.texture.width, stalagmite.texture.height},
-                            (Vector2){.x = (j * TILE_SIZE + (j * TILE_SIZE + TILE_SIZE)) / 2,
-                            .y = (i * TILE_SIZE + (i * TILE_SIZE + TILE_SIZE)) / 2}, 90.0 * (rotations), WHITE); */
-                    break;
-                case STALACTITE:
-                    DrawTextureRec(stalactite.texture,
-                            (Rectangle){(float)(stalactite.texture.width / 4) * rotations,
-                            0.0f, (float)(stalactite.texture.width / 4), (float)(stalactite.texture.height)},
-                            (Vector2){.x = j * TILE_SIZE, .y = i * TILE_SIZE}, WHITE);
-                    break;
-            }
+    if (raceMode) {
+        // The opponent shows only in the same room turned the same way
+        const GameState *opponent = GetRaceOpponent();
+
+        if ((opponent != NULL) && (opponent->currentRoom == view->state.currentRoom) && (opponent->rotations == view->state.rotations)) {
+            DrawAnimation(&opponentAnimator, GetPlayerPosition(&opponent->player), opponent->player.direction, Fade(SKYBLUE, 0.5f));
         }
     }
+    DrawAnimation(&playerAnimator, GetPlayerPosition(&view->state.player), view->state.player.direction, WHITE);
+    DrawTiles();
+    DrawParticles();
+    EndLighting();
+
     DrawTextureRec(oxygen_bar, (Rectangle){0.0f, 0.0f, (float)(oxygen_bar.width), (float)(oxygen_bar.height)}, (Vector2){.x = 0.0f, .y = 0.0f}, WHITE);
-    DrawRectangleRec((Rectangle){player.oxygen / MAX_OXYGEN * oxygen_bar.width, TILE_SIZE / 4 + 2, oxygen_bar.width - (player.oxygen / MAX_OXYGEN * oxygen_bar.width), TILE_SIZE / 2}, RED);
+    float oxygen = FIXED_TO_FLOAT(view->state.player.oxygen) / MAX_OXYGEN;
+    DrawRectangleRec((Rectangle){oxygen * oxygen_bar.width, TILE_SIZE / 4 + 2, oxygen_bar.width - (oxygen * oxygen_bar.width), TILE_SIZE / 2}, RED);
+    if (raceMode) DrawRaceStatus(oxygen_bar.width + 10, 4);
 }
 
 // Gameplay Screen Unload logic
 void UnloadGameplayScreen(void)
 {
+    if (raceMode) {
+        CloseRaceSession();
+        raceMode = false;
+    }
+    else {
+        // Keep the progress for the next time the screen is entered
+        StopSimulationThread();
+        game = AcquireSnapshot()->state;
+    }
+    view = NULL;
+
+    UnloadLighting();
+    ResetTileCache();
+
+    UnloadTextureTracked(playerSprite.idle);
+    UnloadTextureTracked(playerSprite.horizontal);
+    UnloadTextureTracked(playerSprite.fall);
+    UnloadTextureTracked(playerSprite.grounded);
+    UnloadTextureTracked(ground.texture);
+    UnloadTextureTracked(stalagmite.texture);
+    UnloadTextureTracked(stalactite.texture);
+    UnloadTextureTracked(oxygen_bar);
+    UnloadTextureTracked(background);
+
+    StopMusicAsync(GameMusic);
+    FlushAudioCommands();
+    UnloadMusicStreamTracked(GameMusic);
+    UnloadSoundTracked(groundedSound);
+    UnloadSoundTracked(rotatingSound);
+    UnloadSoundTracked(fallingSound);
+    UnloadSoundTracked(deathSound);
+    UnloadSoundTracked(lowAirSound);
 }
 
 // Gameplay Screen should finish?
@@ -0,0 +1,200 @@
+/**********************************************************************************************
+*
+*   raylib - Advance Game template
+*
+*   Level Select Screen Functions Definitions (Init, Update, Draw, Unload)
+*
+*   Copyright (c) 2014-2022 Ramon Santamaria (@raysan5)
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+#include "gameplay.h"
+#include "display.h"
+
+#define LEVELS_SPACING 8
+#define LEVELS_CELL_WIDTH (THUMBNAIL_SIZE + LEVELS_SPACING)
+#define LEVELS_CELL_HEIGHT (THUMBNAIL_SIZE + 12 + LEVELS_SPACING)   // Thumbnail, label, spacing
+#define LEVELS_HEADER 32
+#define LEVELS_FOOTER 20
+#define LEVELS_SCROLL_SPEED 15.0f       // Share of the distance to the target covered per second
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int framesCounter = 0;
+static int finishScreen = 0;
+
+static int roomCount = 0;
+static int selected = 0;                // Kept between visits
+static int columns = 1;
+static int left = 0;                    // Grid x, centered
+static float scroll = 0.0f;             // Pixels from the first row to the top of the view
+static float scrollTarget = 0.0f;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int GetViewHeight(void)
+{
+    return GetDisplayHeight() - LEVELS_HEADER - LEVELS_FOOTER;
+}
+
+static Vector2 GetCellPosition(int room)
+{
+    return (Vector2){ (float)(left + (room % columns) * LEVELS_CELL_WIDTH),
+                      (float)(LEVELS_HEADER + (room / columns) * LEVELS_CELL_HEIGHT) - scroll };
+}
+
+static void ClampScroll(void)
+{
+    float maxScroll = (float)(((roomCount + columns - 1) / columns) * LEVELS_CELL_HEIGHT - GetViewHeight());
+
+    if (scrollTarget > maxScroll) scrollTarget = maxScroll;
+    if (scrollTarget < 0.0f) scrollTarget = 0.0f;
+}
+
+static void Select(int room)
+{
+    if (room < 0) room = 0;
+    if (room >= roomCount) room = roomCount - 1;
+    selected = room;
+
+    // Scroll just enough to show the whole row
+    float top = (float)((selected / columns) * LEVELS_CELL_HEIGHT);
+    if (top < scrollTarget) scrollTarget = top;
+    if (top + LEVELS_CELL_HEIGHT > scrollTarget + GetViewHeight()) scrollTarget = top + LEVELS_CELL_HEIGHT - GetViewHeight();
+    ClampScroll();
+}
+
+// Room under the mouse, -1 when none
+static int GetRoomAtMouse(void)
+{
+    Vector2 mouse = GetMousePosition();
+
+    if ((mouse.y < LEVELS_HEADER) || (mouse.y >= GetDisplayHeight() - LEVELS_FOOTER) || (mouse.x < left)) return -1;
+
+    int column = (int)(mouse.x - left) / LEVELS_CELL_WIDTH;
+    int row = (int)(mouse.y - LEVELS_HEADER + scroll) / LEVELS_CELL_HEIGHT;
+    int room = row * columns + column;
+
+    return ((column < columns) && (room < roomCount)) ? room : -1;
+}
+
+//----------------------------------------------------------------------------------
+// Level Select Screen Functions Definition
+//----------------------------------------------------------------------------------
+
+// Level Select Screen Initialization logic
+void InitLevelsScreen(void)
+{
+    framesCounter = 0;
+    finishScreen = 0;
+
+    LoadRoomFiles();
+    InitRoomThumbnails();
+    roomCount = GetRoomCount();
+
+    columns = (GetDisplayWidth() - LEVELS_SPACING) / LEVELS_CELL_WIDTH;
+    if (columns < 1) columns = 1;
+    left = (GetDisplayWidth() - columns * LEVELS_CELL_WIDTH + LEVELS_SPACING) / 2;
+
+    Select(selected);
+    scroll = scrollTarget;
+
+    PreloadGameplayScreen();
+    PreloadTitleScreen();
+}
+
+// Level Select Screen Update logic
+void UpdateLevelsScreen(void)
+{
+    int page = (GetViewHeight() / LEVELS_CELL_HEIGHT) * columns;
+
+    if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) Select(selected - 1);
+    if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) Select(selected + 1);
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) Select(selected - columns);
+    if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) Select(selected + columns);
+    if (IsKeyPressed(KEY_PAGE_UP)) Select(selected - page);
+    if (IsKeyPressed(KEY_PAGE_DOWN)) Select(selected + page);
+    if (IsKeyPressed(KEY_HOME)) Select(0);
+    if (IsKeyPressed(KEY_END)) Select(roomCount - 1);
+
+    scrollTarget -= GetMouseWheelMove() * LEVELS_CELL_HEIGHT;
+    ClampScroll();
+
+    // Click selects, a second click on the selected room plays it
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        int room = GetRoomAtMouse();
+
+        if (room == selected) finishScreen = 2;
+        else if (room >= 0) selected = room;
+    }
+
+    if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE)) finishScreen = 2;       // GAMEPLAY
+    else if (IsKeyPressed(KEY_BACKSPACE)) finishScreen = 1;                         // TITLE
+
+    if (finishScreen == 2) SetGameplayRoom(selected);
+    if (finishScreen) PlaySound(fxCoin);
+
+    float step = LEVELS_SCROLL_SPEED * GetFrameTime();
+    scroll += (scrollTarget - scroll) * ((step < 1.0f) ? step : 1.0f);
+
+    // Only the rows in view get thumbnails
+    int firstRow = (int)(scroll / LEVELS_CELL_HEIGHT);
+    int rows = GetViewHeight() / LEVELS_CELL_HEIGHT + 2;
+    UpdateRoomThumbnails(firstRow * columns, rows * columns);
+}
+
+// Level Select Screen Draw logic
+void DrawLevelsScreen(void)
+{
+    int firstRow = (int)(scroll / LEVELS_CELL_HEIGHT);
+    int rows = GetViewHeight() / LEVELS_CELL_HEIGHT + 2;
+
+    ClearBackground(BLACK);
+
+    for (int room = firstRow * columns; (room < (firstRow + rows) * columns) && (room < roomCount); room++) {
+        Vector2 position = GetCellPosition(room);
+        Color color = (room == selected) ? GOLD : GRAY;
+
+        if (!DrawRoomThumbnail(room, position)) DrawRectangle((int)position.x, (int)position.y, THUMBNAIL_SIZE, THUMBNAIL_SIZE, (Color){ 28, 22, 20, 255 });
+        if (room == selected) DrawRectangleLinesEx((Rectangle){ position.x - 2, position.y - 2, THUMBNAIL_SIZE + 4, THUMBNAIL_SIZE + 4 }, 2, GOLD);
+        DrawText(TextFormat("ROOM %i", room + 1), (int)position.x, (int)position.y + THUMBNAIL_SIZE + 3, 10, color);
+    }
+
+    // Rows scrolled past the edges go under the header and the footer
+    DrawRectangle(0, 0, GetDisplayWidth(), LEVELS_HEADER, BLACK);
+    DrawText("SELECT ROOM", 8, 8, 20, RAYWHITE);
+    DrawText(TextFormat("%i/%i", selected + 1, roomCount), GetDisplayWidth() - 56, 14, 10, GRAY);
+    DrawRectangle(0, GetDisplayHeight() - LEVELS_FOOTER, GetDisplayWidth(), LEVELS_FOOTER, BLACK);
+    DrawText("ARROWS SELECT, ENTER PLAY, BACKSPACE BACK", 8, GetDisplayHeight() - 15, 10, DARKGRAY);
+}
+
+// Level Select Screen Unload logic
+void UnloadLevelsScreen(void)
+{
+    UnloadRoomThumbnails();
+}
+
+// Level Select Screen should finish?
+int FinishLevelsScreen(void)
+{
+    return finishScreen;
+}
@@ -25,6 +25,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "display.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -57,8 +58,8 @@ void InitLogoScreen(void)
     framesCounter = 0;
     lettersCount = 0;
 
-    logoPositionX = GetScreenWidth()/2 - 128;
-    logoPositionY = GetScreenHeight()/2 - 128;
+    logoPositionX = GetDisplayWidth()/2 - 128;
+    logoPositionY = GetDisplayHeight()/2 - 128;
 
     topSideRecWidth = 16;
     leftSideRecHeight = 16;
@@ -152,9 +153,9 @@ void DrawLogoScreen(void)
         DrawRectangle(logoPositionX + 240, logoPositionY + 16, 16, rightSideRecHeight - 32, Fade(BLACK, alpha));
         DrawRectangle(logoPositionX, logoPositionY + 240, bottomSideRecWidth, 16, Fade(BLACK, alpha));
 
-        DrawRectangle(GetScreenWidth()/2 - 112, GetScreenHeight()/2 - 112, 224, 224, Fade(RAYWHITE, alpha));
+        DrawRectangle(GetDisplayWidth()/2 - 112, GetDisplayHeight()/2 - 112, 224, 224, Fade(RAYWHITE, alpha));
 
-        DrawText(TextSubtext("raylib", 0, lettersCount), GetScreenWidth()/2 - 44, GetScreenHeight()/2 + 48, 50, Fade(BLACK, alpha));
+        DrawText(TextSubtext("raylib", 0, lettersCount), GetDisplayWidth()/2 - 44, GetDisplayHeight()/2 + 48, 50, Fade(BLACK, alpha));
 
         if (framesCounter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
     }
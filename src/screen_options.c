@@ -25,6 +25,8 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "display.h"
+#include "pacing.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -32,6 +34,53 @@
 static int framesCounter = 0;
 static int finishScreen = 0;
 
+typedef enum _OptionItem {
+    OPTION_SCALING,
+    OPTION_WINDOW,
+    OPTION_FULLSCREEN,
+    OPTION_PACING,
+    OPTION_BACK,
+    OPTION_COUNT
+} OptionItem;
+
+static int selected = 0;
+static int windowScale = 1;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Steps the selected option by direction (-1 or 1)
+static void ChangeOption(int item, int direction)
+{
+    switch (item) {
+        case OPTION_SCALING: SetDisplayScaling((GetDisplayScaling() == DISPLAY_INTEGER) ? DISPLAY_FIT : DISPLAY_INTEGER); break;
+        case OPTION_WINDOW:
+        {
+            windowScale += direction;
+            if (windowScale < 1) windowScale = 4;
+            if (windowScale > 4) windowScale = 1;
+            if (!IsWindowFullscreen()) SetWindowScale(windowScale);
+        } break;
+        case OPTION_FULLSCREEN: ToggleFullscreen(); break;
+        case OPTION_PACING: SetFramePacing((GetFramePacingMode() + PACING_MODE_COUNT + direction) % PACING_MODE_COUNT, GetFramePacingCap()); break;
+        case OPTION_BACK: finishScreen = 1; break;
+        default: break;
+    }
+}
+
+static const char *GetOptionText(int item)
+{
+    switch (item) {
+        case OPTION_SCALING: return TextFormat("SCALING      %s", (GetDisplayScaling() == DISPLAY_INTEGER) ? "INTEGER" : "FIT");
+        case OPTION_WINDOW: return TextFormat("WINDOW       %iX", windowScale);
+        case OPTION_FULLSCREEN: return TextFormat("FULLSCREEN   %s", IsWindowFullscreen() ? "ON" : "OFF");
+        case OPTION_PACING: return TextFormat("PACING       %s", TextToUpper(GetFramePacingName(GetFramePacingMode())));
+        case OPTION_BACK: return "BACK";
+        default: return "";
+    }
+}
+
 //----------------------------------------------------------------------------------
 // Options Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -39,27 +88,43 @@ static int finishScreen = 0;
 // Options Screen Initialization logic
 void InitOptionsScreen(void)
 {
-    // TODO: Initialize OPTIONS screen variables here!
     framesCounter = 0;
     finishScreen = 0;
+    selected = 0;
+    windowScale = GetScreenWidth() / GetDisplayWidth();
+    if (windowScale < 1) windowScale = 1;
+    PreloadTitleScreen();       // Only leads back to the title
 }
 
 // Options Screen Update logic
 void UpdateOptionsScreen(void)
 {
-    // TODO: Update OPTIONS screen variables here!
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) selected = (selected + OPTION_COUNT - 1) % OPTION_COUNT;
+    if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) selected = (selected + 1) % OPTION_COUNT;
+
+    if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) ChangeOption(selected, -1);
+    if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D) || IsKeyPressed(KEY_ENTER)) ChangeOption(selected, 1);
+    if (IsKeyPressed(KEY_BACKSPACE)) finishScreen = 1;
+
+    if (finishScreen) PlaySound(fxCoin);
 }
 
 // Options Screen Draw logic
 void DrawOptionsScreen(void)
 {
-    // TODO: Draw OPTIONS screen here!
+    ClearBackground(BLACK);
+    DrawText("OPTIONS", 20, 20, 20, RAYWHITE);
+
+    for (int i = 0; i < OPTION_COUNT; i++) {
+        DrawText(GetOptionText(i), 40, 70 + 24 * i, 10, (i == selected) ? GOLD : GRAY);
+    }
+    DrawText(">", 28, 70 + 24 * selected, 10, GOLD);
+    DrawText("UP/DOWN SELECT, LEFT/RIGHT CHANGE", 20, GetDisplayHeight() - 24, 10, DARKGRAY);
 }
 
 // Options Screen Unload logic
 void UnloadOptionsScreen(void)
 {
-    // TODO: Unload OPTIONS screen variables here!
 }
 
 // Options Screen should finish?
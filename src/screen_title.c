@@ -25,6 +25,9 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "memtrack.h"
+#include "audio.h"
+#include "preload.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -39,32 +42,51 @@ Music titleMusic;
 // Title Screen Functions Definition
 //----------------------------------------------------------------------------------
 
+// Title Screen assets decoded ahead, by the screens leading here
+void PreloadTitleScreen(void)
+{
+    PreloadImage("resources/art/TitleCard.png");
+}
+
 // Title Screen Initialization logic
 void InitTitleScreen(void)
 {
     // TODO: Initialize TITLE screen variables here!
-    Image logo_image = LoadImage("resources/art/TitleCard.png");
-    titleMusic = LoadMusicStream("resources/music/TitleSong.wav");
-    logo = LoadTextureFromImage(logo_image);
-    PlayMusicStream(titleMusic);
+    framesCounter = 0;
+    finishScreen = 0;
+    Image logo_image = GetPreloadedImage("resources/art/TitleCard.png");
+    titleMusic = LoadMusicStreamTracked("resources/music/TitleSong.wav");
+    logo = LoadTextureFromImageTracked(logo_image);
+    UnloadImageTracked(logo_image);
+    PlayMusicAsync(titleMusic, 1.0f);
+    PreloadGameplayScreen();    // Decoded while the title shows
 }
 
 // Title Screen Update logic
 void UpdateTitleScreen(void)
 {
     // TODO: Update TITLE screen variables here!
-    if (!IsMusicStreamPlaying(titleMusic)) {
-        PlayMusicStream(titleMusic);
-    }
-    UpdateMusicStream(titleMusic);
-
-    // Press enter or tap to change to GAMEPLAY screen
+    // Press enter or tap to change to GAMEPLAY screen, O for OPTIONS, L to pick a room, N for a race against another instance
     if (IsKeyPressed(KEY_SPACE) || IsGestureDetected(GESTURE_TAP))
     {
-        //finishScreen = 1;   // OPTIONS
         finishScreen = 2;   // GAMEPLAY
         PlaySound(fxCoin);
     }
+    else if (IsKeyPressed(KEY_O))
+    {
+        finishScreen = 1;   // OPTIONS
+        PlaySound(fxCoin);
+    }
+    else if (IsKeyPressed(KEY_N))
+    {
+        finishScreen = 3;   // GAMEPLAY, race mode
+        PlaySound(fxCoin);
+    }
+    else if (IsKeyPressed(KEY_L))
+    {
+        finishScreen = 4;   // LEVELS
+        PlaySound(fxCoin);
+    }
 }
 
 // Title Screen Draw logic
@@ -76,14 +98,14 @@ void DrawTitleScreen(void)
 // Title Screen Unload logic
 void UnloadTitleScreen(void)
 {
-    // TODO: Unload TITLE screen variables here!
-    StopMusicStream(titleMusic);
+    StopMusicAsync(titleMusic);
+    FlushAudioCommands();
+    UnloadMusicStreamTracked(titleMusic);
+    UnloadTextureTracked(logo);
 }
 
 // Title Screen should finish?
 int FinishTitleScreen(void)
 {
-    // UnloadMusicStream(titleMusic);
-    // UnloadTexture(logo);
     return finishScreen;
 }
@@ -29,7 +29,7 @@
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
-typedef enum GameScreen { LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDING } GameScreen;
+typedef enum GameScreen { LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDING, LEVELS } GameScreen;
 
 //----------------------------------------------------------------------------------
 // Global Variables Declaration (shared by several modules)
@@ -59,6 +59,7 @@ int FinishLogoScreen(void);
 //----------------------------------------------------------------------------------
 // Title Screen Functions Declaration
 //----------------------------------------------------------------------------------
+void PreloadTitleScreen(void);
 void InitTitleScreen(void);
 void UpdateTitleScreen(void);
 void DrawTitleScreen(void);
@@ -77,12 +78,27 @@ int FinishOptionsScreen(void);
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Declaration
 //----------------------------------------------------------------------------------
+void PreloadGameplayScreen(void);
+void SetGameplayRace(bool race);        // Before InitGameplayScreen(), for that visit only
+void SetGameplayRoom(int room);         // Before InitGameplayScreen(), starts over in that room
+void SetGameplayBenchmark(bool benchmark);  // Fixed seed, rooms as set up by the caller (no room files)
+void LoadRoomFiles(void);               // Room files over the built-in rooms, while nothing simulates
+void SetGameplayBackgroundDetail(bool detailed);    // Background tiles, plain black otherwise
 void InitGameplayScreen(void);
 void UpdateGameplayScreen(void);
 void DrawGameplayScreen(void);
 void UnloadGameplayScreen(void);
 int FinishGameplayScreen(void);
 
+//----------------------------------------------------------------------------------
+// Level Select Screen Functions Declaration
+//----------------------------------------------------------------------------------
+void InitLevelsScreen(void);
+void UpdateLevelsScreen(void);
+void DrawLevelsScreen(void);
+void UnloadLevelsScreen(void);
+int FinishLevelsScreen(void);
+
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Declaration
 //----------------------------------------------------------------------------------
@@ -0,0 +1,273 @@
+/**********************************************************************************************
+*
+*   Simulation Thread Functions Definitions
+*
+*   The gameplay state lives on its own thread and advances in fixed SIM_TICK_TIME
+*   ticks: input is consumed from the lock-free input queue, the tick runs, deaths and
+*   exits move the respawn point and are recorded to telemetry, the rewind buffer
+*   records the tick and a snapshot is published. Delayed actions (the low oxygen
+*   warning) are timers keyed on the tick number, so they fire on the same tick on
+*   every replay. The render thread only ever reads snapshots.
+*
+*   Snapshots go through a triple buffer: the simulation writes the back slot and swaps
+*   it with the middle one, the renderer swaps the middle one with its front slot when
+*   a newer snapshot is flagged. Neither side ever waits on the other. Events are
+*   published as running counts, so ticks the renderer skipped still show up as a
+*   changed count.
+*
+*   Without threads (PLATFORM_WEB) the same ticks run on the caller from
+*   UpdateSimulationThread(). Stepped (the benchmark) also runs on the caller, one tick
+*   per call whatever the clock says, so a run takes the same ticks on every machine.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "telemetry.h"
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <time.h>
+#endif
+
+#define SNAPSHOT_FRESH 4                    // Set on the middle index when it was not read yet
+#define SIM_MAX_LAG 0.25                    // Seconds behind before ticks are dropped instead of caught up
+#define SIM_MAX_TIMERS 4096
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum _SimTimer {
+    TIMER_OXYGEN_LOW                        // Oxygen reaches OXYGEN_WARNING
+} SimTimer;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static GameSnapshot snapshots[3] = { 0 };
+static int frontSlot = 0;                   // Render thread only
+static int middleSlot = 1;                  // Shared, index | SNAPSHOT_FRESH
+static int backSlot = 2;                    // Simulation thread only
+
+// Owned by the simulation thread while it runs
+static GameState game = { 0 };
+static unsigned int tick = 0;
+static unsigned int eventCounts[GAME_EVENT_KINDS] = { 0 };
+static unsigned int rewindTicks = 0;
+static Vector2 deathPosition = { 0 };
+static unsigned int roomTick = 0;          // Tick the current room was entered
+static TimerWheel timers = { 0 };          // Advanced once per tick, in step with tick
+static TimerHandle oxygenTimer = 0;
+static double inlineTime = 0.0;
+static bool stepped = false;
+
+#if !defined(PLATFORM_WEB)
+static pthread_t simThread;
+static bool simRunning = false;
+static bool simQuit = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void FillSnapshot(GameSnapshot *snapshot)
+{
+    snapshot->state = game;
+    snapshot->tick = tick;
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) snapshot->eventCounts[k] = eventCounts[k];
+    snapshot->rewindTicks = rewindTicks;
+    snapshot->deathPosition = deathPosition;
+    snapshot->inputLatency = GetInputLatency();
+}
+
+static void PublishSnapshot(void)
+{
+    FillSnapshot(&snapshots[backSlot]);
+    backSlot = __atomic_exchange_n(&middleSlot, backSlot | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL) & 3;
+}
+
+// Oxygen drains at a fixed rate, so the warning tick is known as soon as oxygen is set
+static void ScheduleOxygenWarning(void)
+{
+    int low = GetSimulationOxygenWarning();
+    int drain = GetSimulationOxygenDrain();
+
+    CancelTimer(&timers, oxygenTimer);
+    oxygenTimer = 0;
+    if ((drain > 0) && (game.player.oxygen > low)) {
+        oxygenTimer = ScheduleTimer(&timers, (unsigned int)((game.player.oxygen - low + drain - 1) / drain), TIMER_OXYGEN_LOW, 0);
+    }
+}
+
+static int RunTimers(void)
+{
+    TimerEvent timer = { 0 };
+    int events = EVENT_NONE;
+
+    AdvanceTimerWheel(&timers);
+    while (PopExpiredTimer(&timers, &timer)) {
+        switch (timer.action) {
+            case TIMER_OXYGEN_LOW: events |= EVENT_OXYGEN_LOW; oxygenTimer = 0; break;
+            default: break;
+        }
+    }
+    return events;
+}
+
+static void StepSimulation(double tickTime)
+{
+    int input = ConsumeGameInput(tickTime);
+
+    // Hold backspace to step back one tick per tick
+    if (input & INPUT_REWIND) {
+        RewindFrame(&game);
+        RunTimers();
+        ScheduleOxygenWarning();
+        tick++;
+        rewindTicks++;
+        PublishSnapshot();
+        return;
+    }
+
+    int previousVelocity = game.player.velocity.x;
+    Vector2 previousPosition = GetPlayerPosition(&game.player);
+    int room = game.currentRoom;
+    int events = UpdateGameState(&game, input);
+    Vector2 position = GetPlayerPosition(&game.player);
+    float roomTime = (tick - roomTick) * SIM_TICK_TIME;
+
+    events |= RunTimers();
+
+    MarkInputResponse((events & EVENT_ROTATED) || (game.player.velocity.x != previousVelocity));
+
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) {
+        if (events & (1 << k)) eventCounts[k]++;
+    }
+
+    if (events & EVENT_ROTATED) RecordTelemetry(TELEMETRY_ROTATE, tick, room, game.rotations, position.x, position.y, roomTime);
+    if (events & EVENT_EXIT) {
+        RecordTelemetry(TELEMETRY_ROOM_EXIT, tick, room, game.rotations, previousPosition.x, previousPosition.y, roomTime);
+        RecordTelemetry(TELEMETRY_ROOM_ENTER, tick, game.currentRoom, game.rotations, position.x, position.y, 0.0f);
+        roomTick = tick;
+        SetRespawnPoint(&game);
+        ScheduleOxygenWarning();
+    }
+    if (events & EVENT_DEATH) {
+        RecordTelemetry((events & EVENT_DEATH_OXYGEN) ? TELEMETRY_DEATH_OXYGEN : TELEMETRY_DEATH_HAZARD, tick, room,
+                        game.rotations, position.x, position.y, roomTime);
+        deathPosition = position;
+        RestoreRespawnPoint(&game);
+        ScheduleOxygenWarning();
+    }
+
+    RecordRewindFrame(&game);
+    tick++;
+    PublishSnapshot();
+}
+
+#if !defined(PLATFORM_WEB)
+static void SleepSeconds(double seconds)
+{
+    struct timespec wait = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+    nanosleep(&wait, NULL);
+}
+
+static void *RunSimulation(void *data)
+{
+    double next = GetTime();
+
+    while (!__atomic_load_n(&simQuit, __ATOMIC_ACQUIRE)) {
+        double now = GetTime();
+
+        if (now < next) {
+            SleepSeconds(next - now);
+            continue;
+        }
+
+        StepSimulation(next);
+        next += SIM_TICK_TIME;
+        if (now - next > SIM_MAX_LAG) next = now;
+    }
+
+    return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Simulation Thread Functions Definition
+//----------------------------------------------------------------------------------
+void StartSimulationThread(const GameState *state)
+{
+    Vector2 position = GetPlayerPosition(&state->player);
+
+    game = *state;
+    tick = 0;
+    for (int k = 0; k < GAME_EVENT_KINDS; k++) eventCounts[k] = 0;
+    rewindTicks = 0;
+    deathPosition = position;
+    roomTick = 0;
+
+    timers = LoadTimerWheel(SIM_MAX_TIMERS);
+    oxygenTimer = 0;
+    ScheduleOxygenWarning();
+
+    RecordTelemetry(TELEMETRY_ROOM_ENTER, 0, game.currentRoom, game.rotations, position.x, position.y, 0.0f);
+
+    for (int s = 0; s < 3; s++) FillSnapshot(&snapshots[s]);
+    frontSlot = 0;
+    middleSlot = 1;
+    backSlot = 2;
+    inlineTime = GetTime();
+
+#if !defined(PLATFORM_WEB)
+    simQuit = false;
+    simRunning = !stepped && (pthread_create(&simThread, NULL, RunSimulation, NULL) == 0);
+    if (!simRunning && !stepped) TraceLog(LOG_WARNING, "SIM: Thread failed, simulating on the main loop");
+#endif
+}
+
+void StopSimulationThread(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (simRunning) {
+        __atomic_store_n(&simQuit, true, __ATOMIC_RELEASE);
+        pthread_join(simThread, NULL);
+        simRunning = false;
+    }
+#endif
+    UnloadTimerWheel(timers);
+    timers = (TimerWheel){ 0 };
+}
+
+void UpdateSimulationThread(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (simRunning) return;
+#endif
+    if (stepped) {
+        inlineTime += SIM_TICK_TIME;
+        StepSimulation(inlineTime);
+        return;
+    }
+
+    double now = GetTime();
+
+    if (now - inlineTime > SIM_MAX_LAG) inlineTime = now - SIM_TICK_TIME;
+    while (inlineTime + SIM_TICK_TIME <= now) {
+        inlineTime += SIM_TICK_TIME;
+        StepSimulation(inlineTime);
+    }
+}
+
+void SetSimulationStepped(bool enabled)
+{
+    stepped = enabled;
+}
+
+const GameSnapshot *AcquireSnapshot(void)
+{
+    if (__atomic_load_n(&middleSlot, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH) {
+        frontSlot = __atomic_exchange_n(&middleSlot, frontSlot, __ATOMIC_ACQ_REL) & 3;
+    }
+    return &snapshots[frontSlot];
+}
@@ -0,0 +1,425 @@
+/**********************************************************************************************
+*
+*   Gameplay Simulation Functions Definitions
+*
+*   Room loading, rotation, collision and player physics working on a GameState value.
+*   Nothing in here touches the window, input or audio devices, so the same code drives
+*   the gameplay screen and headless tools (playtest harness). Everything the caller may
+*   want to react to (sounds, respawn) is reported back as GameEvent flags.
+*
+*   All of it is integer math: positions, speeds and oxygen are fixed point, a tick is
+*   always SIM_TICK_TIME and a quarter turn swaps coordinates around the room center.
+*   The same inputs give bit-identical states on every platform, so replays, lockstep
+*   races and state hashes never drift. Floats only come in through the settings,
+*   converted once in SetSimulationOxygen().
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FIXED_TILE FIXED(TILE_SIZE)
+#define PLAYER_SPEED FIXED(2)                               // Pixels per tick
+#define PLAYER_GRAVITY (FIXED(98) / 10 / SIM_TICK_RATE)     // Per tick, 9.8 pixels per tick every second
+#define ROTATE_NUDGE (FIXED_ONE / 10)                       // Out of a wall the room turned into
+#define OXYGEN_LIMIT ((float)(INT_MAX / FIXED_ONE))         // Most oxygen units 16.16 holds
+#define OXYGEN_PER_TICK(drain) (((drain) + SIM_TICK_RATE / 2) / SIM_TICK_RATE)  // Fixed per second to per tick, rounded
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int maxOxygen = FIXED(MAX_OXYGEN);
+static int oxygenDrain = OXYGEN_PER_TICK(FIXED(OXYGEN_DRAIN));
+
+// Rooms loaded from files replace the built-in room_tile ones
+static TileType roomFiles[NUM_ROOMS][ROOM_SIZE][ROOM_SIZE] = { 0 };
+static bool roomFileLoaded[NUM_ROOMS] = { 0 };
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// xorshift32, kept in the state so every instance has its own deterministic sequence
+static int GetStateRandomValue(GameState *state, int min, int max)
+{
+    unsigned int x = state->seed;
+    if (x == 0) x = 0x9e3779b9;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->seed = x;
+    return min + (int)(x % (unsigned int)(max - min + 1));
+}
+
+static void RotateTiles(Room *room)
+{
+    for (int i = 0; i < (ROOM_SIZE + 1) / 2; i ++) {
+        for (int j = 0; j < ROOM_SIZE / 2; j++) {
+            TileType temp = room->tiles[ROOM_SIZE - 1 - j][i];
+            room->tiles[ROOM_SIZE - 1 - j][i] = room->tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1];
+            room->tiles[ROOM_SIZE - 1 - i][ROOM_SIZE - j - 1] = room->tiles[j][ROOM_SIZE - 1 -i];
+            room->tiles[j][ROOM_SIZE - 1 - i] = room->tiles[i][j];
+            room->tiles[i][j] = temp;
+        }
+    }
+}
+
+static bool CheckCollisionY(GameState *state, int *events)
+{
+    Player *player = &state->player;
+    Room *room = &state->room;
+    int left_tile = player->position.x / FIXED_TILE;
+    int right_tile = (player->position.x + FIXED_TILE) / FIXED_TILE;
+    int bottom_tile = (player->position.y + FIXED_TILE) / FIXED_TILE;
+
+    // A player pushed out of the room by a rotation must not index outside the room
+    if(left_tile < 0) left_tile = 0;
+    if(left_tile > ROOM_SIZE - 1) left_tile = ROOM_SIZE - 1;
+    if(right_tile < 0) right_tile = 0;
+    if(right_tile > ROOM_SIZE - 1) right_tile = ROOM_SIZE - 1;
+    if(bottom_tile < 0) bottom_tile = 0;
+    if(bottom_tile > ROOM_SIZE - 1) bottom_tile = ROOM_SIZE - 1;
+
+    bool any_collision = false;
+    if (room->tiles[bottom_tile][left_tile] == EXIT || room->tiles[bottom_tile][right_tile] == EXIT) {
+        *events |= EVENT_EXIT;
+        return false;
+    }
+    if (IsDeath(room->tiles[bottom_tile][left_tile]) || IsDeath(room->tiles[bottom_tile][right_tile])) {
+        *events |= EVENT_DEATH_HAZARD;
+        return false;
+    }
+    for(int j = left_tile; j <= right_tile; j++)
+    {
+        TileType t = room->tiles[bottom_tile][j];
+        if (IsSolid(t) && ((player->position.x < j * FIXED_TILE) || ((player->position.x + FIXED(player->width)) > j * FIXED_TILE))) {
+            any_collision = true;
+            if ((player->position.y + FIXED(player->height)) > (bottom_tile * FIXED_TILE)) {
+                *events |= EVENT_GROUNDED;
+                player->state = GROUNDED;
+                player->velocity.y = 0;
+                player->position.y = (bottom_tile - 1) * FIXED_TILE;
+            }
+        }
+    }
+    if (!any_collision) {
+        *events |= EVENT_FALLING;
+        player->state = FALL;
+    }
+    return any_collision;
+}
+
+static bool CheckCollisionX(GameState *state, int *events)
+{
+    Player *player = &state->player;
+    Room *room = &state->room;
+    int left_tile = player->position.x / FIXED_TILE;
+    int right_tile = (player->position.x + FIXED_TILE) / FIXED_TILE;
+    int top_tile = player->position.y / FIXED_TILE;
+
+    if(left_tile < 0) left_tile = 0;
+    if(left_tile > ROOM_SIZE - 1) left_tile = ROOM_SIZE - 1;
+    if(right_tile < 0) right_tile = 0;
+    if(right_tile > ROOM_SIZE - 1) right_tile = ROOM_SIZE - 1;
+    if(top_tile < 0) top_tile = 0;
+    if(top_tile > ROOM_SIZE - 1) top_tile = ROOM_SIZE - 1;
+
+    bool any_collision = false;
+    if (room->tiles[top_tile][right_tile] == EXIT) {
+        *events |= EVENT_EXIT;
+        return false;
+    }
+    if (IsDeath(room->tiles[top_tile][right_tile])) {
+        *events |= EVENT_DEATH_HAZARD;
+        return false;
+    }
+    for(int j = left_tile; j <= right_tile; j++)
+    {
+        TileType t = room->tiles[top_tile][j];
+        if (IsSolid(t)) {
+            if (player->state == ROTATING) {
+                player->velocity.x = (j == left_tile) ? ROTATE_NUDGE : -ROTATE_NUDGE;
+            }
+            any_collision = true;
+        }
+    }
+    return any_collision;
+}
+
+static const TileType (*GetRoomTiles(int room_num))[ROOM_SIZE]
+{
+    return roomFileLoaded[room_num] ? roomFiles[room_num] : room_tile[room_num];
+}
+
+// Room tiles as stored (unrotated) plus the start tile of the current rotation
+static void CopyRoomTiles(Room *room, int room_num, int rotations)
+{
+    const TileType (*tiles)[ROOM_SIZE] = GetRoomTiles(room_num);
+
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) room->tiles[i][j] = tiles[i][j];
+    }
+    for (int r = 0; r < rotations; r++) RotateTiles(room);
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) {
+            if (room->tiles[i][j] == START) {
+                room->start.x = j;
+                room->start.y = i;
+            }
+        }
+    }
+}
+
+// Exit and death end the tick, on exit the next room is already loaded
+static bool TickEnded(GameState *state, int events)
+{
+    if (events & EVENT_EXIT) LoadRoom(state, state->nextRoom);
+    return (events & (EVENT_EXIT | EVENT_DEATH));
+}
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Definition
+//----------------------------------------------------------------------------------
+void SetSimulationOxygen(float max, float drain)
+{
+    if (max > OXYGEN_LIMIT) max = OXYGEN_LIMIT;
+    if (drain > OXYGEN_LIMIT) drain = OXYGEN_LIMIT;
+
+    // Same rounding as the default, the game and the headless tools must agree to the tick
+    maxOxygen = (int)lroundf(max * FIXED_ONE);
+    oxygenDrain = OXYGEN_PER_TICK((int)lroundf(drain * FIXED_ONE));
+}
+
+int GetSimulationMaxOxygen(void)
+{
+    return maxOxygen;
+}
+
+int GetSimulationOxygenDrain(void)
+{
+    return oxygenDrain;
+}
+
+int GetSimulationOxygenWarning(void)
+{
+    return (int)((long long)maxOxygen * OXYGEN_WARNING / 100);
+}
+
+Player GetDefaultPlayer(void)
+{
+    return (Player){ { 0, 0 }, { 0, 0 }, IDLE, RIGHT, 16 * SCALAR, 16 * SCALAR, maxOxygen, 0 };
+}
+
+Vector2 GetPlayerPosition(const Player *player)
+{
+    return (Vector2){ FIXED_TO_FLOAT(player->position.x), FIXED_TO_FLOAT(player->position.y) };
+}
+
+int GetRoomCount(void)
+{
+    return NUM_ROOMS;
+}
+
+Room GetRoomLayout(int room_num)
+{
+    Room room = { 0 };
+
+    if ((room_num >= 0) && (room_num < NUM_ROOMS)) CopyRoomTiles(&room, room_num, 0);
+    return room;
+}
+
+bool IsSolid(TileType tile) {
+    bool result = false;
+    switch (tile) {
+        case GROUND:
+            result = true;
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+bool IsDeath(TileType tile) {
+    bool result = false;
+    switch (tile) {
+        case STALAGMITE:
+            result = true;
+            break;
+        case STALACTITE:
+            result = true;
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+void RotateRoom(GameState *state) {
+    Player *player = &state->player;
+    FixedVector2 oldposition = player->position;
+    int center = (ROOM_SIZE / 2) * FIXED_TILE;
+
+    RotateTiles(&state->room);
+
+    // A quarter turn, exact: x' = -(y - c) + c, y' = (x - c) + c
+    player->position.x = center - (oldposition.y - center);
+    player->position.y = center + (oldposition.x - center);
+
+    state->rotations++;
+    if (state->rotations > 3) {
+        state->rotations = 0;
+    }
+}
+
+void LoadRoom(GameState *state, int room_num) {
+    Room *room = &state->room;
+    if (room_num < 0) room_num = 0;
+    if (room_num >= NUM_ROOMS) room_num = (NUM_ROOMS - 1);
+    CopyRoomTiles(room, room_num, state->rotations);
+
+    for (int i = 0; i < BACKGROUND_TILES; i++) {
+        for (int j = 0; j < BACKGROUND_TILES; j++) {
+            room->background[i][j] = GetStateRandomValue(state, 1, 10);
+        }
+    }
+
+    state->player.position.x = (int)room->start.x * FIXED_TILE;
+    state->player.position.y = (int)room->start.y * FIXED_TILE;
+    state->player.oxygen = maxOxygen;
+    state->currentRoom = room_num;
+    state->nextRoom = room_num + 1;
+    if (state->nextRoom >= NUM_ROOMS) state->nextRoom = 0;
+}
+
+// Room file: ROOM_SIZE rows of ROOM_SIZE TileType numbers, lines starting with '#' are comments.
+// Nothing is logged here, headless tools link this file without raylib
+bool LoadRoomFile(int room_num, const char *fileName)
+{
+    if ((room_num < 0) || (room_num >= NUM_ROOMS)) return false;
+
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return false;
+
+    TileType tiles[ROOM_SIZE * ROOM_SIZE];
+    int count = 0;
+    bool valid = true;
+    char line[256];
+
+    while (valid && (fgets(line, sizeof(line), file) != NULL)) {
+        char *cursor = line;
+
+        if (line[0] == '#') continue;
+        while (valid) {
+            char *end = NULL;
+            long value = strtol(cursor, &end, 10);
+
+            if (end == cursor) break;
+            valid = (count < ROOM_SIZE * ROOM_SIZE) && (value >= AIR) && (value <= RAIL);
+            if (valid) tiles[count++] = (TileType)value;
+            cursor = end;
+            while ((*cursor == ' ') || (*cursor == ',') || (*cursor == '\t')) cursor++;
+        }
+    }
+    fclose(file);
+
+    if (!valid || (count != ROOM_SIZE * ROOM_SIZE)) return false;
+
+    for (int i = 0; i < ROOM_SIZE * ROOM_SIZE; i++) roomFiles[room_num][i / ROOM_SIZE][i % ROOM_SIZE] = tiles[i];
+    roomFileLoaded[room_num] = true;
+    return true;
+}
+
+// Same as a room file, for rooms made in code
+void SetRoomTiles(int room_num, const TileType tiles[ROOM_SIZE][ROOM_SIZE])
+{
+    if ((room_num < 0) || (room_num >= NUM_ROOMS)) return;
+
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) roomFiles[room_num][i][j] = tiles[i][j];
+    }
+    roomFileLoaded[room_num] = true;
+}
+
+// Swap in the current room's tiles, keeping rotation, background and the player unless
+// the player now overlaps solid ground
+void ReloadRoomTiles(GameState *state)
+{
+    Player *player = &state->player;
+
+    CopyRoomTiles(&state->room, state->currentRoom, state->rotations);
+
+    int left = player->position.x / FIXED_TILE;
+    int top = player->position.y / FIXED_TILE;
+    int right = (player->position.x + FIXED(player->width - 1)) / FIXED_TILE;
+    int bottom = (player->position.y + FIXED(player->height - 1)) / FIXED_TILE;
+    bool blocked = false;
+
+    for (int i = top; i <= bottom; i++) {
+        for (int j = left; j <= right; j++) {
+            if ((i < 0) || (j < 0) || (i >= ROOM_SIZE) || (j >= ROOM_SIZE) || IsSolid(state->room.tiles[i][j])) blocked = true;
+        }
+    }
+
+    if (blocked) {
+        player->position.x = (int)state->room.start.x * FIXED_TILE;
+        player->position.y = (int)state->room.start.y * FIXED_TILE;
+        player->velocity = (FixedVector2){ 0, 0 };
+    }
+}
+
+// Advance one tick, the caller decides what to do on EVENT_DEATH (respawn, reset...)
+int UpdateGameState(GameState *state, int input)
+{
+    Player *player = &state->player;
+    PlayerState previousState = player->state;
+    int events = EVENT_NONE;
+
+    player->position.x += player->velocity.x;
+    if (CheckCollisionX(state, &events)) {
+        player->position.x -= player->velocity.x;
+    }
+    if (TickEnded(state, events)) return events;
+
+    player->position.y += player->velocity.y;
+    if (CheckCollisionY(state, &events)) {
+        player->position.y -= player->velocity.y;
+    }
+    if (TickEnded(state, events)) return events;
+
+    if (input & INPUT_LEFT) {
+        if (player->state == IDLE) player->state = WALKING;
+        player->direction = LEFT;
+        player->velocity.x = -PLAYER_SPEED;
+    } else if (input & INPUT_RIGHT) {
+        if (player->state == IDLE) player->state = WALKING;
+        player->direction = RIGHT;
+        player->velocity.x = PLAYER_SPEED;
+    } else {
+        if (player->state == WALKING) player->state = IDLE;
+        player->velocity.x = 0;
+    }
+
+    if (player->state == FALL) player->velocity.y += PLAYER_GRAVITY;
+
+    if (input & INPUT_ROTATE) {
+        RotateRoom(state);
+        events |= EVENT_ROTATED;
+    }
+
+    player->oxygen -= oxygenDrain;
+    if (player->oxygen <= 0) events |= EVENT_DEATH_OXYGEN;
+
+    if (player->state != previousState) player->stateTicks = 0;
+    else player->stateTicks++;
+    if ((player->state == GROUNDED) && (player->stateTicks >= GETUP_TICKS)) {
+        player->state = IDLE;
+        player->stateTicks = 0;
+    }
+
+    return events;
+}
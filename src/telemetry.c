@@ -0,0 +1,274 @@
+/**********************************************************************************************
+*
+*   Telemetry Functions Definitions
+*
+*   Each recording thread claims one ring the first time it records and gives it back
+*   when it exits (thread-specific key destructor), so the simulation thread started
+*   for every gameplay session reuses the same few rings. Rings are single producer
+*   (the owning thread) / single consumer (the flush thread): each side only writes its
+*   own index, published with release/acquire atomics. The flush thread wakes every
+*   TELEMETRY_FLUSH_INTERVAL, appends whatever the rings hold and rotates the file when
+*   it grew too large.
+*
+*   On PLATFORM_WEB there are no threads, one ring is shared and UpdateTelemetry()
+*   flushes it once per frame.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "telemetry.h"
+#include <stdio.h>
+#include <time.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+#endif
+
+#define TELEMETRY_RING_SIZE 2048            // Records per thread, power of two
+#define TELEMETRY_MAX_THREADS 8
+#define TELEMETRY_FLUSH_INTERVAL 0.25       // Seconds between flushes
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _TelemetryRing {
+    TelemetryRecord records[TELEMETRY_RING_SIZE];
+    unsigned int head;                      // Written by the owning thread only
+    unsigned int tail;                      // Written by the flush thread only
+    unsigned int dropped;                   // Written by the owning thread only
+    int owned;
+} TelemetryRing;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static TelemetryRing rings[TELEMETRY_MAX_THREADS] = { 0 };
+static __thread TelemetryRing *localRing = NULL;
+static __thread bool localRingFailed = false;
+
+static bool telemetryEnabled = false;
+static double startTime = 0.0;
+
+// Owned by the flush thread
+static char baseName[256] = { 0 };
+static FILE *file = NULL;
+static long fileBytes = 0;
+static uint32_t session = 0;
+static uint32_t sequence = 0;
+static unsigned int written = 0;
+
+#if !defined(PLATFORM_WEB)
+static pthread_key_t ringKey;
+static pthread_t flusher;
+static bool flusherRunning = false;
+static bool flusherQuit = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void GetTelemetryFileName(char *name, int size, int index)
+{
+    if (index == 0) snprintf(name, size, "%s.bin", baseName);
+    else snprintf(name, size, "%s.%i.bin", baseName, index);
+}
+
+// Shift <name>.bin to <name>.1.bin and so on, dropping the oldest file
+static void ShiftTelemetryFiles(void)
+{
+    char from[280];
+    char to[280];
+
+    GetTelemetryFileName(to, sizeof(to), TELEMETRY_MAX_FILES - 1);
+    remove(to);
+    for (int i = TELEMETRY_MAX_FILES - 2; i >= 0; i--) {
+        GetTelemetryFileName(from, sizeof(from), i);
+        GetTelemetryFileName(to, sizeof(to), i + 1);
+        rename(from, to);
+    }
+}
+
+static void OpenTelemetryFile(void)
+{
+    char name[280];
+    TelemetryHeader header = { TELEMETRY_MAGIC, TELEMETRY_VERSION, sizeof(TelemetryRecord), session, sequence };
+
+    GetTelemetryFileName(name, sizeof(name), 0);
+    file = fopen(name, "wb");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "TELEMETRY: [%s] Failed to open file, records are discarded", name);
+        return;
+    }
+
+    fwrite(&header, sizeof(header), 1, file);
+    fileBytes = sizeof(header);
+    sequence++;
+}
+
+static void RotateTelemetryFile(void)
+{
+    if (file != NULL) fclose(file);
+    ShiftTelemetryFiles();
+    OpenTelemetryFile();
+}
+
+// Append every record queued so far, runs on the flush thread
+static void FlushRings(void)
+{
+    for (int r = 0; r < TELEMETRY_MAX_THREADS; r++) {
+        TelemetryRing *ring = &rings[r];
+        unsigned int head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        unsigned int tail = ring->tail;
+
+        if (head == tail) continue;
+
+        if (file != NULL) {
+            unsigned int first = tail & (TELEMETRY_RING_SIZE - 1);
+            unsigned int count = head - tail;
+            unsigned int chunk = TELEMETRY_RING_SIZE - first;
+
+            // The queued range wraps at most once
+            if (chunk > count) chunk = count;
+            fwrite(&ring->records[first], sizeof(TelemetryRecord), chunk, file);
+            if (count > chunk) fwrite(&ring->records[0], sizeof(TelemetryRecord), count - chunk, file);
+
+            fileBytes += (long)(count * sizeof(TelemetryRecord));
+            written += count;
+        }
+
+        __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+    }
+
+    if (file != NULL) {
+        fflush(file);
+        if (fileBytes >= TELEMETRY_FILE_SIZE) RotateTelemetryFile();
+    }
+}
+
+static TelemetryRing *ClaimRing(void)
+{
+#if defined(PLATFORM_WEB)
+    return &rings[0];
+#else
+    for (int r = 0; r < TELEMETRY_MAX_THREADS; r++) {
+        int expected = 0;
+
+        if (__atomic_compare_exchange_n(&rings[r].owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            pthread_setspecific(ringKey, &rings[r]);
+            return &rings[r];
+        }
+    }
+    return NULL;
+#endif
+}
+
+#if !defined(PLATFORM_WEB)
+// Thread exit, the ring keeps its queued records for the flush thread
+static void ReleaseRing(void *ring)
+{
+    __atomic_store_n(&((TelemetryRing *)ring)->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void *RunFlusher(void *data)
+{
+    struct timespec wait = { 0, (long)(TELEMETRY_FLUSH_INTERVAL * 1e9) };
+
+    while (!__atomic_load_n(&flusherQuit, __ATOMIC_ACQUIRE)) {
+        nanosleep(&wait, NULL);
+        FlushRings();
+    }
+
+    return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Telemetry Functions Definition
+//----------------------------------------------------------------------------------
+void InitTelemetry(const char *fileName)
+{
+    snprintf(baseName, sizeof(baseName), "%s", fileName);
+    session = (uint32_t)time(NULL);
+    sequence = 0;
+    written = 0;
+    startTime = GetTime();
+
+    // A previous session is kept as <name>.1.bin
+    ShiftTelemetryFiles();
+    OpenTelemetryFile();
+
+#if !defined(PLATFORM_WEB)
+    pthread_key_create(&ringKey, ReleaseRing);
+    flusherQuit = false;
+    flusherRunning = (pthread_create(&flusher, NULL, RunFlusher, NULL) == 0);
+    if (!flusherRunning) TraceLog(LOG_WARNING, "TELEMETRY: Flush thread failed, flushing on the main loop");
+#endif
+
+    __atomic_store_n(&telemetryEnabled, true, __ATOMIC_RELEASE);
+    RecordTelemetry(TELEMETRY_SESSION, 0, 0, 0, 0.0f, 0.0f, 0.0f);
+}
+
+void CloseTelemetry(void)
+{
+    unsigned int dropped = 0;
+
+    __atomic_store_n(&telemetryEnabled, false, __ATOMIC_RELEASE);
+
+#if !defined(PLATFORM_WEB)
+    if (flusherRunning) {
+        __atomic_store_n(&flusherQuit, true, __ATOMIC_RELEASE);
+        pthread_join(flusher, NULL);
+        flusherRunning = false;
+    }
+#endif
+
+    FlushRings();
+    if (file != NULL) fclose(file);
+    file = NULL;
+
+    for (int r = 0; r < TELEMETRY_MAX_THREADS; r++) dropped += __atomic_load_n(&rings[r].dropped, __ATOMIC_RELAXED);
+    TraceLog(LOG_INFO, "TELEMETRY: %u records written, %u dropped", written, dropped);
+}
+
+void UpdateTelemetry(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (flusherRunning) return;
+#endif
+    FlushRings();
+}
+
+void RecordTelemetry(TelemetryType type, uint32_t tick, int room, int rotations, float x, float y, float value)
+{
+    if (!__atomic_load_n(&telemetryEnabled, __ATOMIC_ACQUIRE)) return;
+
+    if (localRing == NULL) {
+        if (localRingFailed) return;
+        localRing = ClaimRing();
+        if (localRing == NULL) {
+            localRingFailed = true;
+            TraceLog(LOG_WARNING, "TELEMETRY: No ring left for this thread, records are discarded");
+            return;
+        }
+    }
+
+    TelemetryRing *ring = localRing;
+    unsigned int head = ring->head;
+
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= TELEMETRY_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    TelemetryRecord *record = &ring->records[head & (TELEMETRY_RING_SIZE - 1)];
+    record->time = (uint32_t)((GetTime() - startTime) * 1000.0);
+    record->tick = tick;
+    record->type = (uint8_t)type;
+    record->room = (uint8_t)room;
+    record->rotations = (uint16_t)rotations;
+    record->x = x;
+    record->y = y;
+    record->value = value;
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,75 @@
+/**********************************************************************************************
+*
+*   Gameplay Telemetry
+*
+*   Fixed-size binary records (deaths, room exits, rotations...) written by the game
+*   threads into per-thread lock-free rings, drained by a background thread into a
+*   local file. RecordTelemetry() only copies one record into the calling thread's
+*   ring, so it stays on in release builds; a full ring drops the record and counts it.
+*
+*   Files: <name>.bin is the one being written, when it grows past TELEMETRY_FILE_SIZE
+*   it becomes <name>.1.bin, the older ones shift up to <name>.<TELEMETRY_MAX_FILES-1>.bin
+*   and the last one is deleted. Every file starts with a TelemetryHeader followed by
+*   TelemetryRecords; read them with telemetry_report (make telemetry_report).
+*
+*   This header does not need raylib, the offline reader includes it alone.
+*
+**********************************************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#define TELEMETRY_MAGIC 0x314d4c54          // "TLM1"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_FILE_SIZE (1 << 20)       // Bytes before the file is rotated
+#define TELEMETRY_MAX_FILES 4               // Current file included
+
+typedef enum _TelemetryType {
+    TELEMETRY_SESSION = 0,                  // Game started, the file header holds the session
+    TELEMETRY_ROOM_ENTER,
+    TELEMETRY_ROOM_EXIT,                    // value: seconds spent in the room
+    TELEMETRY_ROTATE,
+    TELEMETRY_DEATH_HAZARD,                 // value: seconds spent in the room
+    TELEMETRY_DEATH_OXYGEN,
+    TELEMETRY_TYPE_COUNT
+} TelemetryType;
+
+// Written once at the start of every file
+typedef struct _TelemetryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t session;                       // Seconds since epoch when the game started
+    uint32_t sequence;                      // Files written this session before this one
+} TelemetryHeader;
+
+typedef struct _TelemetryRecord {
+    uint32_t time;                          // Milliseconds since InitTelemetry()
+    uint32_t tick;                          // Simulation tick
+    uint8_t type;                           // TelemetryType
+    uint8_t room;
+    uint16_t rotations;                     // Room rotation (0..3) at the event
+    float x;                                // Player position, world units
+    float y;
+    float value;                            // Depends on the type
+} TelemetryRecord;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Telemetry Functions Declaration
+//----------------------------------------------------------------------------------
+void InitTelemetry(const char *fileName);           // File name without extension, starts the flush thread
+void CloseTelemetry(void);                          // Flushes everything recorded so far
+void UpdateTelemetry(void);                         // Once per frame, only flushes without threads
+void RecordTelemetry(TelemetryType type, uint32_t tick, int room, int rotations, float x, float y, float value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,198 @@
+/**********************************************************************************************
+*
+*   Telemetry Report
+*
+*   Reads the binary files written by the game (see telemetry.h) and prints a per-room
+*   summary: entries, exits and time to exit, deaths by cause, rotations, plus the
+*   cells where players die the most.
+*
+*   Build: make telemetry_report (plain C, no raylib needed)
+*
+*   Usage: ./telemetry_report [files...]
+*       Without files reads telemetry.bin and its rotated telemetry.<n>.bin files
+*
+**********************************************************************************************/
+
+#include "telemetry.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_ROOMS 256                       // TelemetryRecord.room is one byte
+#define CELL_SIZE 32                        // TILE_SIZE, world units
+#define ROOM_CENTER 160.0f                  // (ROOM_SIZE/2)*TILE_SIZE, rooms rotate around it
+#define GRID_CELLS 16
+#define MAX_HOTSPOTS 10
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _RoomReport {
+    long entries;
+    long exits;
+    long hazardDeaths;
+    long oxygenDeaths;
+    long rotations;
+    double exitSeconds;
+    float minExit;
+    float maxExit;
+    long deathCells[GRID_CELLS][GRID_CELLS];
+} RoomReport;
+
+typedef struct _Hotspot {
+    int room;
+    int x;
+    int y;
+    long deaths;
+} Hotspot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static RoomReport rooms[MAX_ROOMS] = { 0 };
+static long sessions = 0;
+static long records = 0;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int ClampCell(float position)
+{
+    int cell = (int)(position / CELL_SIZE);
+    if (cell < 0) return 0;
+    if (cell >= GRID_CELLS) return GRID_CELLS - 1;
+    return cell;
+}
+
+// Positions are recorded in the rotated room, RotateRoom() backwards gives the room as built
+static void UnrotatePosition(const TelemetryRecord *record, float *x, float *y)
+{
+    for (int r = 0; r < (record->rotations & 3); r++) {
+        float turned = ROOM_CENTER + (*y - ROOM_CENTER);
+        *y = ROOM_CENTER - (*x - ROOM_CENTER);
+        *x = turned;
+    }
+}
+
+static void AddRecord(const TelemetryRecord *record)
+{
+    RoomReport *room = &rooms[record->room];
+
+    switch (record->type) {
+        case TELEMETRY_SESSION: sessions++; break;
+        case TELEMETRY_ROOM_ENTER: room->entries++; break;
+        case TELEMETRY_ROOM_EXIT: {
+            room->exits++;
+            room->exitSeconds += record->value;
+            if ((room->exits == 1) || (record->value < room->minExit)) room->minExit = record->value;
+            if (record->value > room->maxExit) room->maxExit = record->value;
+        } break;
+        case TELEMETRY_ROTATE: room->rotations++; break;
+        case TELEMETRY_DEATH_HAZARD:
+        case TELEMETRY_DEATH_OXYGEN: {
+            float x = record->x;
+            float y = record->y;
+
+            if (record->type == TELEMETRY_DEATH_HAZARD) room->hazardDeaths++;
+            else room->oxygenDeaths++;
+            UnrotatePosition(record, &x, &y);
+            room->deathCells[ClampCell(y)][ClampCell(x)]++;
+        } break;
+        default: return;
+    }
+    records++;
+}
+
+static bool ReadFile(const char *fileName, bool quiet)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) {
+        if (!quiet) fprintf(stderr, "telemetry_report: cannot open %s\n", fileName);
+        return false;
+    }
+
+    TelemetryHeader header = { 0 };
+    if ((fread(&header, sizeof(header), 1, file) != 1) || (header.magic != TELEMETRY_MAGIC) ||
+        (header.version != TELEMETRY_VERSION) || (header.recordSize != sizeof(TelemetryRecord))) {
+        fprintf(stderr, "telemetry_report: %s is not a telemetry v%d file\n", fileName, TELEMETRY_VERSION);
+        fclose(file);
+        return false;
+    }
+
+    TelemetryRecord batch[1024];
+    size_t count = 0;
+    while ((count = fread(batch, sizeof(TelemetryRecord), 1024, file)) > 0) {
+        for (size_t i = 0; i < count; i++) AddRecord(&batch[i]);
+    }
+    fclose(file);
+    return true;
+}
+
+static int CompareHotspot(const void *a, const void *b)
+{
+    long x = ((const Hotspot *)a)->deaths;
+    long y = ((const Hotspot *)b)->deaths;
+    return (y > x) - (y < x);
+}
+
+static void PrintReport(int files)
+{
+    static Hotspot hotspots[MAX_ROOMS * GRID_CELLS * GRID_CELLS];
+    int hotspotCount = 0;
+
+    printf("Telemetry: %d files, %ld sessions, %ld records\n\n", files, sessions, records);
+    printf("room   entries    exits   exit s avg/min/max       hazard   oxygen  rotations  rot/exit\n");
+    for (int r = 0; r < MAX_ROOMS; r++) {
+        const RoomReport *room = &rooms[r];
+
+        if ((room->entries == 0) && (room->exits == 0) && (room->hazardDeaths == 0) && (room->oxygenDeaths == 0)) continue;
+
+        double avgExit = (room->exits > 0) ? room->exitSeconds / room->exits : 0.0;
+        double rotationsPerExit = (room->exits > 0) ? (double)room->rotations / room->exits : 0.0;
+        printf("%4d  %8ld %8ld   %6.2f/%6.2f/%6.2f  %8ld %8ld  %9ld  %8.2f\n", r, room->entries, room->exits,
+               avgExit, room->minExit, room->maxExit, room->hazardDeaths, room->oxygenDeaths, room->rotations, rotationsPerExit);
+
+        for (int y = 0; y < GRID_CELLS; y++) {
+            for (int x = 0; x < GRID_CELLS; x++) {
+                if (room->deathCells[y][x] > 0) hotspots[hotspotCount++] = (Hotspot){ r, x, y, room->deathCells[y][x] };
+            }
+        }
+    }
+
+    if (hotspotCount == 0) return;
+
+    qsort(hotspots, hotspotCount, sizeof(Hotspot), CompareHotspot);
+    printf("\nDeath hotspots (room: cell x, y)\n");
+    for (int i = 0; (i < hotspotCount) && (i < MAX_HOTSPOTS); i++) {
+        printf("%4d: %2d, %2d  %8ld\n", hotspots[i].room, hotspots[i].x, hotspots[i].y, hotspots[i].deaths);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int files = 0;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) files += ReadFile(argv[i], false);
+    }
+    else {
+        char name[64];
+        for (int i = TELEMETRY_MAX_FILES - 1; i >= 0; i--) {
+            if (i == 0) snprintf(name, sizeof(name), "telemetry.bin");
+            else snprintf(name, sizeof(name), "telemetry.%d.bin", i);
+            files += ReadFile(name, true);
+        }
+    }
+
+    if (files == 0) {
+        fprintf(stderr, "telemetry_report: no telemetry files read\n");
+        return 1;
+    }
+
+    PrintReport(files);
+
+    return 0;
+}
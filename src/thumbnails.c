@@ -0,0 +1,278 @@
+/**********************************************************************************************
+*
+*   Room Thumbnail Functions Definitions
+*
+*   Thumbnails live in one atlas texture, a slot per room shown recently; when the atlas
+*   is full the slot drawn longest ago is reused. Only rooms that are about to be drawn
+*   are made, at most THUMBNAIL_BATCH per frame: each one is first looked up in the disk
+*   cache, a file per room layout named after the hash of its tiles, and the ones missing
+*   there are drawn side by side into a staging texture with the game's tile art, read
+*   back in one go, written to the cache and copied into the atlas.
+*
+*   The tile sheets are only loaded for the first room that is not cached, a screen that
+*   finds everything on disk never touches them.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include "display.h"
+#include "preload.h"
+#include <stdio.h>
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define MakeCacheDirectory(path) _mkdir(path)
+#else
+    #include <sys/stat.h>
+    #define MakeCacheDirectory(path) mkdir(path, 0755)
+#endif
+
+#define THUMBNAIL_ATLAS_SIZE 512
+#define THUMBNAIL_COLUMNS (THUMBNAIL_ATLAS_SIZE / THUMBNAIL_SIZE)
+#define THUMBNAIL_SLOTS (THUMBNAIL_COLUMNS * THUMBNAIL_COLUMNS)
+#define THUMBNAIL_BATCH 8                   // Made per frame at most, cached or rendered
+#define THUMBNAIL_CACHE "cache"
+#define THUMBNAIL_VERSION 1                 // Bump when the art changes, older files are ignored
+#define THUMBNAIL_BACKGROUND (Color){ 28, 22, 20, 255 }
+#define THUMBNAIL_EXIT (Color){ 168, 134, 52, 255 }   // Exits have no sprite, the game lights them
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _ThumbnailSlot {
+    int room;                               // -1 when free
+    unsigned int lastUsed;                  // Frame it was last asked for
+} ThumbnailSlot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static Texture2D atlas = { 0 };
+static RenderTexture2D staging = { 0 };     // THUMBNAIL_BATCH thumbnails side by side
+static Texture2D sheets[3] = { 0 };         // Ground, stalagmite, stalactite
+static bool sheetsLoaded = false;
+
+static ThumbnailSlot slots[THUMBNAIL_SLOTS] = { 0 };
+static int *roomSlots = NULL;               // Per room, -1 while not in the atlas
+static int roomCount = 0;
+static unsigned int frame = 0;
+
+static int cachedCount = 0;
+static int renderedCount = 0;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// FNV-1a over the tiles, the thumbnail size and version go in first
+static unsigned long long HashRoomLayout(const Room *room)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    unsigned int header[2] = { THUMBNAIL_VERSION, THUMBNAIL_SIZE };
+    const unsigned char *bytes = (const unsigned char *)header;
+
+    for (int i = 0; i < (int)sizeof(header); i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) hash = (hash ^ (unsigned char)room->tiles[i][j]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const char *GetThumbnailPath(unsigned long long hash)
+{
+    return TextFormat("%s/room_%016llx.png", THUMBNAIL_CACHE, hash);
+}
+
+static Rectangle GetSlotRect(int slot)
+{
+    return (Rectangle){ (float)((slot % THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE), (float)((slot / THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE),
+                        (float)THUMBNAIL_SIZE, (float)THUMBNAIL_SIZE };
+}
+
+// A free slot, or the one asked for longest ago
+static int TakeSlot(void)
+{
+    int oldest = 0;
+
+    for (int s = 0; s < THUMBNAIL_SLOTS; s++) {
+        if (slots[s].room < 0) return s;
+        if ((int)(slots[s].lastUsed - slots[oldest].lastUsed) < 0) oldest = s;
+    }
+    roomSlots[slots[oldest].room] = -1;
+    return oldest;
+}
+
+// image is THUMBNAIL_SIZE square, R8G8B8 like the atlas
+static void PlaceThumbnail(int room, Image image)
+{
+    int slot = TakeSlot();
+
+    UpdateTextureRec(atlas, GetSlotRect(slot), image.data);
+    slots[slot] = (ThumbnailSlot){ room, frame };
+    roomSlots[room] = slot;
+}
+
+static bool LoadCachedThumbnail(int room, unsigned long long hash)
+{
+    const char *path = GetThumbnailPath(hash);
+
+    if (!FileExists(path)) return false;
+
+    LockDecode();
+    Image image = LoadImage(path);
+    UnlockDecode();
+
+    bool valid = (image.data != NULL) && (image.width == THUMBNAIL_SIZE) && (image.height == THUMBNAIL_SIZE);
+
+    if (valid) {
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+        PlaceThumbnail(room, image);
+        cachedCount++;
+    }
+    UnloadImage(image);
+    return valid;
+}
+
+static void LoadThumbnailSheets(void)
+{
+    static const char *fileNames[3] = {
+        "resources/art/Ground_Tiles-Sheet.png",
+        "resources/art/Stalagmite_Rotate-Sheet.png",
+        "resources/art/Stalactite_Rotate-Sheet.png"
+    };
+
+    // Drawn at a fifth of their size, mipmaps keep them from shimmering
+    for (int i = 0; i < 3; i++) {
+        Image image = LoadImageTracked(fileNames[i]);
+        sheets[i] = LoadTextureFromImageTracked(image);
+        UnloadImageTracked(image);
+        GenTextureMipmaps(&sheets[i]);
+        SetTextureFilter(sheets[i], TEXTURE_FILTER_TRILINEAR);
+    }
+    SetTileSheets(&sheets[0], &sheets[1], &sheets[2]);
+    sheetsLoaded = true;
+}
+
+static void RenderThumbnails(const int *rooms, const unsigned long long *hashes, int count)
+{
+    Camera2D camera = { 0 };
+
+    if (!sheetsLoaded) LoadThumbnailSheets();
+    camera.zoom = (float)THUMBNAIL_SIZE / (ROOM_SIZE * TILE_SIZE);
+
+    PushRenderTarget(staging);
+    ClearBackground(THUMBNAIL_BACKGROUND);
+    for (int k = 0; k < count; k++) {
+        Room room = GetRoomLayout(rooms[k]);
+
+        camera.offset.x = (float)(k * THUMBNAIL_SIZE);
+        UpdateTileCache(&room, 0);
+        BeginMode2D(camera);
+            for (int i = 0; i < ROOM_SIZE; i++) {
+                for (int j = 0; j < ROOM_SIZE; j++) {
+                    if (room.tiles[i][j] == EXIT) DrawRectangle(j * TILE_SIZE, i * TILE_SIZE, TILE_SIZE, TILE_SIZE, THUMBNAIL_EXIT);
+                }
+            }
+            DrawTiles();
+        EndMode2D();
+    }
+    PopRenderTarget();
+
+    // Render textures come back bottom up, alpha is dropped so blended sprite edges stay opaque
+    Image strip = LoadImageFromTexture(staging.texture);
+    ImageFlipVertical(&strip);
+    ImageFormat(&strip, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+
+    for (int k = 0; k < count; k++) {
+        Image image = ImageFromImage(strip, (Rectangle){ (float)(k * THUMBNAIL_SIZE), 0.0f, (float)THUMBNAIL_SIZE, (float)THUMBNAIL_SIZE });
+
+        LockDecode();
+        bool exported = ExportImage(image, GetThumbnailPath(hashes[k]));
+        UnlockDecode();
+
+        if (!exported) TraceLog(LOG_WARNING, "THUMBNAILS: Room %i not cached", rooms[k]);
+        PlaceThumbnail(rooms[k], image);
+        UnloadImage(image);
+        renderedCount++;
+    }
+    UnloadImage(strip);
+}
+
+//----------------------------------------------------------------------------------
+// Room Thumbnail Functions Definition
+//----------------------------------------------------------------------------------
+void InitRoomThumbnails(void)
+{
+    Image image = GenImageColor(THUMBNAIL_ATLAS_SIZE, THUMBNAIL_ATLAS_SIZE, THUMBNAIL_BACKGROUND);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+    atlas = LoadTextureFromImageTracked(image);
+    UnloadImage(image);
+    staging = LoadRenderTextureTracked(THUMBNAIL_SIZE * THUMBNAIL_BATCH, THUMBNAIL_SIZE);
+
+    roomCount = GetRoomCount();
+    roomSlots = (int *)MemAllocTracked(roomCount * sizeof(int), "room thumbnail slots");
+    for (int r = 0; r < roomCount; r++) roomSlots[r] = -1;
+    for (int s = 0; s < THUMBNAIL_SLOTS; s++) slots[s] = (ThumbnailSlot){ -1, 0 };
+
+    MakeCacheDirectory(THUMBNAIL_CACHE);
+    cachedCount = 0;
+    renderedCount = 0;
+}
+
+void UnloadRoomThumbnails(void)
+{
+    if ((cachedCount + renderedCount) > 0) TraceLog(LOG_INFO, "THUMBNAILS: %i from the cache, %i rendered", cachedCount, renderedCount);
+
+    if (sheetsLoaded) {
+        ResetTileCache();
+        for (int i = 0; i < 3; i++) UnloadTextureTracked(sheets[i]);
+        sheetsLoaded = false;
+    }
+    UnloadRenderTextureTracked(staging);
+    UnloadTextureTracked(atlas);
+    MemFreeTracked(roomSlots);
+    roomSlots = NULL;
+    roomCount = 0;
+}
+
+void UpdateRoomThumbnails(int first, int count)
+{
+    int missing[THUMBNAIL_BATCH] = { 0 };
+    unsigned long long hashes[THUMBNAIL_BATCH] = { 0 };
+    int missingCount = 0;
+    int made = 0;
+
+    if (first < 0) first = 0;
+    if (first + count > roomCount) count = roomCount - first;
+
+    // Marked first, so nothing about to be drawn is taken for the new ones
+    frame++;
+    for (int room = first; room < first + count; room++) {
+        if (roomSlots[room] >= 0) slots[roomSlots[room]].lastUsed = frame;
+    }
+
+    for (int room = first; (room < first + count) && (made < THUMBNAIL_BATCH); room++) {
+        if (roomSlots[room] >= 0) continue;
+
+        Room layout = GetRoomLayout(room);
+        unsigned long long hash = HashRoomLayout(&layout);
+
+        if (!LoadCachedThumbnail(room, hash)) {
+            missing[missingCount] = room;
+            hashes[missingCount++] = hash;
+        }
+        made++;
+    }
+
+    if (missingCount > 0) RenderThumbnails(missing, hashes, missingCount);
+}
+
+bool DrawRoomThumbnail(int room, Vector2 position)
+{
+    if ((room < 0) || (room >= roomCount) || (roomSlots[room] < 0)) return false;
+
+    DrawTextureRec(atlas, GetSlotRect(roomSlots[room]), position, WHITE);
+    return true;
+}
@@ -0,0 +1,176 @@
+/**********************************************************************************************
+*
+*   Tilemap Functions Definitions
+*
+*   Picks the art for every room cell once per room layout instead of every frame.
+*   Ground tiles use a 4-neighbour bitmask so exposed faces get the matching edge frame,
+*   hazards pick their frame from the room orientation. The result is a flat list of
+*   (sheet, source rect, dest rect) drawn as is, sheets are at art size and scaled up by
+*   SCALAR on the GPU.
+*
+*   One list is cached per orientation together with the tiles it was built from, so
+*   rotating back and forth reuses lists and any other tile change (new room, respawn,
+*   rewind) is caught by comparing the tiles.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include <string.h>
+
+#define GROUND_FRAMES 15
+#define GROUND_VARIANTS 3
+#define STALAGMITE_FRAMES 16
+#define STALACTITE_FRAMES 4
+
+// Ground sheet layout, GROUND_VARIANTS frames per face
+#define GROUND_LEFT 0
+#define GROUND_RIGHT 3
+#define GROUND_TOP 6
+#define GROUND_BOTTOM 9
+#define GROUND_INNER 12
+
+// Neighbour bits, set when that neighbour is solid (outside the room counts as solid)
+#define NEIGHBOUR_UP 1
+#define NEIGHBOUR_RIGHT 2
+#define NEIGHBOUR_DOWN 4
+#define NEIGHBOUR_LEFT 8
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _TileSprite {
+    const Texture2D *sheet;
+    Rectangle source;
+    Rectangle dest;
+} TileSprite;
+
+typedef struct _TileDrawList {
+    bool valid;
+    TileType tiles[ROOM_SIZE][ROOM_SIZE];
+    int count;
+    TileSprite sprites[ROOM_SIZE * ROOM_SIZE];
+} TileDrawList;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+
+// The sheet has no corner frames, faces are picked by priority: top, bottom, left, right
+static const int groundFaces[16] = {
+    GROUND_TOP,    GROUND_BOTTOM, GROUND_TOP,  GROUND_BOTTOM,   // ---- | ---U | --R- | --RU
+    GROUND_TOP,    GROUND_LEFT,   GROUND_TOP,  GROUND_LEFT,     // -D-- | -D-U | -DR- | -DRU
+    GROUND_TOP,    GROUND_BOTTOM, GROUND_TOP,  GROUND_BOTTOM,   // L--- | L--U | L-R- | L-RU
+    GROUND_TOP,    GROUND_RIGHT,  GROUND_TOP,  GROUND_INNER     // LD-- | LD-U | LDR- | LDRU
+};
+
+static const Texture2D *groundSheet = NULL;
+static const Texture2D *stalagmiteSheet = NULL;
+static const Texture2D *stalactiteSheet = NULL;
+
+static Rectangle groundFrames[GROUND_FRAMES] = { 0 };
+static Rectangle stalagmiteFrames[STALAGMITE_FRAMES] = { 0 };
+static Rectangle stalactiteFrames[STALACTITE_FRAMES] = { 0 };
+
+static TileDrawList tileCache[4] = { 0 };
+static const TileDrawList *currentList = NULL;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static void SplitSheet(const Texture2D *sheet, Rectangle *frames, int count)
+{
+    float width = (float)(sheet->width / count);
+    for (int i = 0; i < count; i++) frames[i] = (Rectangle){ width * i, 0.0f, width, (float)sheet->height };
+}
+
+static bool IsSolidAt(const Room *room, int i, int j)
+{
+    if ((i < 0) || (j < 0) || (i >= ROOM_SIZE) || (j >= ROOM_SIZE)) return true;
+    return IsSolid(room->tiles[i][j]);
+}
+
+static void BuildDrawList(TileDrawList *list, const Room *room, int rotations)
+{
+    memcpy(list->tiles, room->tiles, sizeof(list->tiles));
+    list->count = 0;
+    list->valid = true;
+
+    for (int i = 0; i < ROOM_SIZE; i++) {
+        for (int j = 0; j < ROOM_SIZE; j++) {
+            TileSprite sprite = { NULL, { 0 }, (Rectangle){ j * TILE_SIZE, i * TILE_SIZE, 0.0f, 0.0f } };
+
+            switch (room->tiles[i][j]) {
+                case GROUND:
+                {
+                    int mask = (IsSolidAt(room, i - 1, j) ? NEIGHBOUR_UP : 0) |
+                               (IsSolidAt(room, i, j + 1) ? NEIGHBOUR_RIGHT : 0) |
+                               (IsSolidAt(room, i + 1, j) ? NEIGHBOUR_DOWN : 0) |
+                               (IsSolidAt(room, i, j - 1) ? NEIGHBOUR_LEFT : 0);
+                    sprite.sheet = groundSheet;
+                    sprite.source = groundFrames[groundFaces[mask] + (i + j) % GROUND_VARIANTS];
+                } break;
+                case STALAGMITE:
+                {
+                    sprite.sheet = stalagmiteSheet;
+                    sprite.source = stalagmiteFrames[rotations * 4 + (i + j) % 4];
+                } break;
+                case STALACTITE:
+                {
+                    sprite.sheet = stalactiteSheet;
+                    sprite.source = stalactiteFrames[rotations];
+                } break;
+                default: break;
+            }
+
+            if (sprite.sheet == NULL) continue;
+
+            sprite.dest.width = sprite.source.width * SCALAR;
+            sprite.dest.height = sprite.source.height * SCALAR;
+            list->sprites[list->count++] = sprite;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Tilemap Functions Definition
+//----------------------------------------------------------------------------------
+void SetTileSheets(const Texture2D *ground, const Texture2D *stalagmite, const Texture2D *stalactite)
+{
+    groundSheet = ground;
+    stalagmiteSheet = stalagmite;
+    stalactiteSheet = stalactite;
+
+    SplitSheet(ground, groundFrames, GROUND_FRAMES);
+    SplitSheet(stalagmite, stalagmiteFrames, STALAGMITE_FRAMES);
+    SplitSheet(stalactite, stalactiteFrames, STALACTITE_FRAMES);
+    ResetTileCache();
+}
+
+void ResetTileCache(void)
+{
+    for (int r = 0; r < 4; r++) tileCache[r].valid = false;
+    currentList = NULL;
+}
+
+void UpdateTileCache(const Room *room, int rotations)
+{
+    TileDrawList *list = &tileCache[rotations & 3];
+
+    if (!list->valid || (memcmp(list->tiles, room->tiles, sizeof(list->tiles)) != 0)) {
+        // A different layout in this orientation means the room changed, drop the others too
+        if (list->valid) ResetTileCache();
+        BuildDrawList(list, room, rotations & 3);
+    }
+    currentList = list;
+}
+
+void DrawTiles(void)
+{
+    if (currentList == NULL) return;
+
+    for (int k = 0; k < currentList->count; k++) {
+        const TileSprite *sprite = &currentList->sprites[k];
+        DrawTexturePro(*sprite->sheet, sprite->source, sprite->dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    }
+}
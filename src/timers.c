@@ -0,0 +1,239 @@
+/**********************************************************************************************
+*
+*   Timer Wheel Functions Definitions
+*
+*   Hierarchical timing wheel keyed on simulation ticks: TIMER_WHEEL_LEVELS levels of
+*   TIMER_WHEEL_SLOTS slots, level n covering delays up to SLOTS^(n+1) ticks. A timer is
+*   linked into the slot of its due tick at the lowest level whose current turn holds it;
+*   every time the level below wraps, one slot of the level above is spread back down.
+*   Scheduling and cancelling only link or unlink one node, advancing costs one slot
+*   plus the occasional cascade.
+*
+*   Nodes live in one fixed pool linked by index, lists are FIFO so timers due on the
+*   same tick expire in the order they were scheduled, the same on every replay.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_MAX_DELAY ((1u << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+#define TIMER_FREE -1               // TimerNode.level when the node is not scheduled
+#define TIMER_EXPIRED -2            // TimerNode.level while waiting in the expired list
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _TimerNode {
+    unsigned int due;
+    int prev;
+    int next;
+    int level;
+    int slot;
+    unsigned int generation;        // Bumped on release, stale handles stop matching
+    int action;
+    int data;
+} TimerNode;
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int *GetListHead(TimerWheel *wheel, const TimerNode *node)
+{
+    return (node->level == TIMER_EXPIRED) ? &wheel->expiredHead : &wheel->heads[node->level][node->slot];
+}
+
+static int *GetListTail(TimerWheel *wheel, const TimerNode *node)
+{
+    return (node->level == TIMER_EXPIRED) ? &wheel->expiredTail : &wheel->tails[node->level][node->slot];
+}
+
+static void LinkNode(TimerWheel *wheel, int index)
+{
+    TimerNode *node = &wheel->nodes[index];
+    int *tail = GetListTail(wheel, node);
+
+    node->prev = *tail;
+    node->next = -1;
+    if (*tail >= 0) wheel->nodes[*tail].next = index;
+    else *GetListHead(wheel, node) = index;
+    *tail = index;
+}
+
+static void UnlinkNode(TimerWheel *wheel, int index)
+{
+    TimerNode *node = &wheel->nodes[index];
+
+    if (node->prev >= 0) wheel->nodes[node->prev].next = node->next;
+    else *GetListHead(wheel, node) = node->next;
+    if (node->next >= 0) wheel->nodes[node->next].prev = node->prev;
+    else *GetListTail(wheel, node) = node->prev;
+}
+
+// Lowest level whose slot range holds both the due tick and the wheel's tick. A timer only
+// gets below a level once the cascade that brings the earlier ones down ran, so timers due
+// on the same tick stay in scheduling order
+static void InsertNode(TimerWheel *wheel, int index)
+{
+    TimerNode *node = &wheel->nodes[index];
+    int level = 0;
+
+    while ((level < TIMER_WHEEL_LEVELS - 1) && ((node->due >> (TIMER_WHEEL_BITS * (level + 1))) != (wheel->tick >> (TIMER_WHEEL_BITS * (level + 1))))) level++;
+
+    node->level = level;
+    node->slot = (node->due >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    LinkNode(wheel, index);
+}
+
+static void ReleaseNode(TimerWheel *wheel, int index)
+{
+    TimerNode *node = &wheel->nodes[index];
+
+    node->level = TIMER_FREE;
+    node->generation++;
+    node->next = wheel->freeHead;
+    wheel->freeHead = index;
+    wheel->count--;
+}
+
+// Spread one slot of a higher level over the levels below
+static void CascadeSlot(TimerWheel *wheel, int level, int slot)
+{
+    int index = wheel->heads[level][slot];
+
+    wheel->heads[level][slot] = -1;
+    wheel->tails[level][slot] = -1;
+
+    while (index >= 0) {
+        int next = wheel->nodes[index].next;
+        InsertNode(wheel, index);
+        index = next;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Timer Wheel Functions Definition
+//----------------------------------------------------------------------------------
+TimerWheel LoadTimerWheel(int capacity)
+{
+    TimerWheel wheel = { 0 };
+
+    if (capacity > TIMER_MAX_CAPACITY) capacity = TIMER_MAX_CAPACITY;
+    wheel.nodes = MemAllocTracked(capacity * sizeof(TimerNode), "timer wheel");
+    wheel.capacity = capacity;
+    ClearTimerWheel(&wheel);
+
+    return wheel;
+}
+
+void UnloadTimerWheel(TimerWheel wheel)
+{
+    if (wheel.nodes != NULL) MemFreeTracked(wheel.nodes);
+}
+
+void ClearTimerWheel(TimerWheel *wheel)
+{
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++) {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++) {
+            wheel->heads[l][s] = -1;
+            wheel->tails[l][s] = -1;
+        }
+    }
+    wheel->expiredHead = -1;
+    wheel->expiredTail = -1;
+
+    // Generations survive, handles from before the clear stay invalid
+    for (int i = 0; i < wheel->capacity; i++) {
+        if (wheel->nodes[i].level != TIMER_FREE) wheel->nodes[i].generation++;
+        wheel->nodes[i].level = TIMER_FREE;
+        wheel->nodes[i].next = (i + 1 < wheel->capacity) ? i + 1 : -1;
+    }
+    wheel->freeHead = (wheel->capacity > 0) ? 0 : -1;
+    wheel->count = 0;
+}
+
+TimerHandle ScheduleTimer(TimerWheel *wheel, unsigned int delay, int action, int data)
+{
+    int index = wheel->freeHead;
+
+    if (index < 0) {
+        TraceLog(LOG_WARNING, "TIMER: Wheel full (%i timers), timer dropped", wheel->capacity);
+        return 0;
+    }
+
+    if (delay < 1) delay = 1;
+    if (delay > TIMER_MAX_DELAY) delay = TIMER_MAX_DELAY;
+
+    TimerNode *node = &wheel->nodes[index];
+    wheel->freeHead = node->next;
+    wheel->count++;
+
+    node->due = wheel->tick + delay;
+    node->action = action;
+    node->data = data;
+    InsertNode(wheel, index);
+
+    return ((node->generation & 0xffff) << 16) | (unsigned int)(index + 1);
+}
+
+bool CancelTimer(TimerWheel *wheel, TimerHandle handle)
+{
+    int index = (int)(handle & 0xffff) - 1;
+
+    if ((index < 0) || (index >= wheel->capacity)) return false;
+
+    TimerNode *node = &wheel->nodes[index];
+    if ((node->level == TIMER_FREE) || ((node->generation & 0xffff) != (handle >> 16))) return false;
+
+    UnlinkNode(wheel, index);
+    ReleaseNode(wheel, index);
+    return true;
+}
+
+void AdvanceTimerWheel(TimerWheel *wheel)
+{
+    unsigned int tick = wheel->tick + 1;
+    int slot = tick & TIMER_WHEEL_MASK;
+
+    // Cascaded timers are placed relative to the new tick
+    wheel->tick = tick;
+
+    // Level 0 wrapped: refill it from level 1, and level 1 from level 2 when that wrapped too...
+    if (slot == 0) {
+        for (int l = 1; l < TIMER_WHEEL_LEVELS; l++) {
+            int upper = (tick >> (TIMER_WHEEL_BITS * l)) & TIMER_WHEEL_MASK;
+            CascadeSlot(wheel, l, upper);
+            if (upper != 0) break;
+        }
+    }
+
+    // Everything left in the slot is due now
+    int index = wheel->heads[0][slot];
+    while (index >= 0) {
+        int next = wheel->nodes[index].next;
+
+        wheel->nodes[index].level = TIMER_EXPIRED;
+        LinkNode(wheel, index);
+        index = next;
+    }
+    wheel->heads[0][slot] = -1;
+    wheel->tails[0][slot] = -1;
+}
+
+bool PopExpiredTimer(TimerWheel *wheel, TimerEvent *event)
+{
+    int index = wheel->expiredHead;
+    if (index < 0) return false;
+
+    TimerNode *node = &wheel->nodes[index];
+    event->action = node->action;
+    event->data = node->data;
+    event->tick = node->due;
+
+    UnlinkNode(wheel, index);
+    ReleaseNode(wheel, index);
+    return true;
+}
@@ -0,0 +1,192 @@
+/**********************************************************************************************
+*
+*   Timer Wheel Check
+*
+*   Randomized check of timers.c against a brute force list of pending timers. Every tick
+*   schedules and cancels timers with delays from one tick to past the top level, so every
+*   level cascades, then compares the expired timers with the ones the list says are due:
+*   same timers, same due tick, same order (scheduling order within a tick). Stale handles
+*   must not cancel anything.
+*
+*   Build: make timers_check (plain C and raylib headers, no window or audio device)
+*
+*   Usage: ./timers_check [ticks] [seed]
+*       Defaults: 300000 ticks, seed 1. Exit code 1 on the first mismatch
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay.h"
+#include "memtrack.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK_CAPACITY 2048
+#define CHECK_DEFAULT_TICKS 300000
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct _PendingTimer {
+    TimerHandle handle;
+    unsigned int due;
+    unsigned int order;         // Scheduling order, breaks ties between timers due together
+    int data;
+} PendingTimer;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static PendingTimer pending[CHECK_CAPACITY] = { 0 };
+static int pendingCount = 0;
+static TimerHandle staleHandles[64] = { 0 };      // Handles of timers gone, oldest overwritten
+static int staleCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Headless stand-ins for what the timer wheel uses from raylib and memtrack.c
+void *MemAllocTracked(unsigned int size, const char *label)
+{
+    (void)label;
+    return malloc(size);
+}
+
+void MemFreeTracked(void *ptr)
+{
+    free(ptr);
+}
+
+void TraceLog(int logLevel, const char *text, ...)
+{
+    va_list args;
+
+    (void)logLevel;
+    va_start(args, text);
+    vfprintf(stderr, text, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static unsigned int NextRandom(unsigned int *seed)
+{
+    unsigned int x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// Mostly short delays, some for every level above, a few past the longest delay
+static unsigned int GetRandomDelay(unsigned int *seed)
+{
+    unsigned int pick = NextRandom(seed) % 100;
+    unsigned int bits = TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS;
+
+    if (pick < 50) return NextRandom(seed) % (TIMER_WHEEL_SLOTS * 2);
+    if (pick < 80) return NextRandom(seed) % (TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS * 2);
+    if (pick < 95) return NextRandom(seed) % (1u << (TIMER_WHEEL_BITS * 3));
+    if (pick < 99) return NextRandom(seed) % (1u << bits);
+    return (1u << bits) + NextRandom(seed) % 1000;
+}
+
+static void ForgetPending(int i)
+{
+    staleHandles[staleCount % 64] = pending[i].handle;
+    staleCount++;
+    pending[i] = pending[--pendingCount];
+}
+
+//----------------------------------------------------------------------------------
+// Program main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    unsigned int ticks = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : CHECK_DEFAULT_TICKS;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    unsigned int maxDelay = (1u << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    unsigned int order = 0;
+    long expired = 0;
+    long cancelled = 0;
+
+    if (seed == 0) seed = 1;
+
+    TimerWheel wheel = LoadTimerWheel(CHECK_CAPACITY);
+
+    for (unsigned int t = 0; t < ticks; t++) {
+        // Schedule a few, up to the capacity minus room for the next tick's
+        int schedules = NextRandom(&seed) % 4;
+        for (int s = 0; (s < schedules) && (pendingCount < CHECK_CAPACITY - 8); s++) {
+            unsigned int delay = GetRandomDelay(&seed);
+            unsigned int clamped = (delay < 1) ? 1 : ((delay > maxDelay) ? maxDelay : delay);
+            TimerHandle handle = ScheduleTimer(&wheel, delay, 0, (int)order);
+
+            if (handle == 0) {
+                printf("FAIL tick %u: wheel full with %i timers pending\n", wheel.tick, pendingCount);
+                return 1;
+            }
+            pending[pendingCount++] = (PendingTimer){ handle, wheel.tick + clamped, order, (int)order };
+            order++;
+        }
+
+        // Cancel one now and then, and try a handle that is no longer valid
+        if ((pendingCount > 0) && ((NextRandom(&seed) % 8) == 0)) {
+            int i = NextRandom(&seed) % pendingCount;
+            if (!CancelTimer(&wheel, pending[i].handle)) {
+                printf("FAIL tick %u: cancelling pending timer %i failed\n", wheel.tick, pending[i].data);
+                return 1;
+            }
+            ForgetPending(i);
+            cancelled++;
+        }
+        if ((staleCount > 0) && CancelTimer(&wheel, staleHandles[NextRandom(&seed) % ((staleCount < 64) ? staleCount : 64)])) {
+            printf("FAIL tick %u: a stale handle cancelled a timer\n", wheel.tick);
+            return 1;
+        }
+
+        AdvanceTimerWheel(&wheel);
+
+        // Expected: every pending timer due now, in scheduling order
+        TimerEvent event = { 0 };
+        long lastOrder = -1;
+        int due = 0;
+
+        for (int i = 0; i < pendingCount; i++) if (pending[i].due == wheel.tick) due++;
+
+        while (PopExpiredTimer(&wheel, &event)) {
+            int found = -1;
+
+            for (int i = 0; (i < pendingCount) && (found < 0); i++) {
+                if ((unsigned int)pending[i].data == (unsigned int)event.data) found = i;
+            }
+            if ((found < 0) || (pending[found].due != wheel.tick) || (event.tick != wheel.tick)) {
+                printf("FAIL tick %u: timer %i expired, due at %u\n", wheel.tick, event.data, (found < 0) ? 0 : pending[found].due);
+                return 1;
+            }
+            if ((long)pending[found].order < lastOrder) {
+                printf("FAIL tick %u: timer %i expired out of scheduling order\n", wheel.tick, event.data);
+                return 1;
+            }
+            lastOrder = pending[found].order;
+            ForgetPending(found);
+            expired++;
+            due--;
+        }
+        if (due != 0) {
+            printf("FAIL tick %u: %i due timers did not expire\n", wheel.tick, due);
+            return 1;
+        }
+        if (wheel.count != pendingCount) {
+            printf("FAIL tick %u: wheel counts %i timers, %i pending\n", wheel.tick, wheel.count, pendingCount);
+            return 1;
+        }
+    }
+
+    printf("timers_check: %u ticks, %u scheduled, %ld expired, %ld cancelled, %i pending: OK\n",
+           ticks, order, expired, cancelled, pendingCount);
+
+    UnloadTimerWheel(wheel);
+    return 0;
+}